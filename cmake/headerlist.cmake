@@ -5,4 +5,20 @@ set(headers ${headers}
     src/Settings.h
     src/SimpleIni.h
     src/Events.h
+    src/RingBuffer.h
+    src/Stats.h
+    src/Cache.h
+    src/FlatMap.h
+    src/Pick.h
+    src/Arena.h
+    src/Serialization.h
+    src/Group.h
+    src/WornSlots.h
+    src/PowTable.h
+    src/Sampling.h
+    src/ShadowStore.h
+    src/Codec.h
+    src/Throttle.h
+    src/ContainerCounts.h
+    src/Materials.h
 )
\ No newline at end of file
@@ -3,4 +3,7 @@ set(sources ${sources}
     src/Settings.cpp
     src/Events.cpp
     src/Tools.cpp
+    src/Stats.cpp
+    src/Cache.cpp
+    src/Serialization.cpp
 )
\ No newline at end of file
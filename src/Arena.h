@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+namespace Tools {
+
+    // Scratch memory for one event: a monotonic resource over a thread-local
+    // buffer that is reused by every event, so a steady-state hit does not
+    // touch the heap. An event that outgrows the buffer falls back to the
+    // heap; a nested arena on the same thread gets no buffer at all.
+    class Arena {
+        public:
+            Arena() {
+                if ((_owner = !InUse())) {
+                    InUse() = true;
+                    _res.emplace(Buffer().data(), Buffer().size(), std::pmr::new_delete_resource());
+                } else
+                    _res.emplace(std::pmr::new_delete_resource());
+            };
+            ~Arena() { if (_owner) InUse() = false; };
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            inline std::pmr::memory_resource* get() { return &*_res; };
+
+            static constexpr std::size_t kBufferSize = 64 * 1024;
+
+        private:
+            static std::array<std::byte, kBufferSize>& Buffer() {
+                alignas(std::max_align_t) thread_local std::array<std::byte, kBufferSize> buffer;
+                return buffer;
+            };
+            static bool& InUse() {
+                thread_local bool inUse = false;
+                return inUse;
+            };
+            bool _owner = false;
+            std::optional<std::pmr::monotonic_buffer_resource> _res;
+    };
+
+}
@@ -0,0 +1,302 @@
+#include "Cache.h"
+#include "Settings.h"
+
+namespace DurabilityNG {
+
+inline RE::ExtraDataList* GetWorn(RE::BSSimpleList<RE::ExtraDataList*>* extraLists, bool left = false) {
+    if (extraLists) {
+        auto edt = left ? RE::ExtraDataType::kWornLeft : RE::ExtraDataType::kWorn;
+        for (auto& edl : *extraLists)
+            if (edl->HasType(edt))
+                return edl;
+    }
+    return nullptr;
+};
+
+const Gear& ActorCache::GetGear(RE::Actor* actor, RE::AIProcess* proc)
+{
+    auto& gear = _actors[actor->GetFormID()].gear;
+    const std::uint32_t equipped = proc->equippedForms.size();
+    if (gear.valid && gear.proc == proc && gear.equipped == equipped) {
+        Count(Stats::GetSingleton()->gearHits);
+        return gear;
+    }
+    Count(Stats::GetSingleton()->gearMisses);
+
+    const auto* settings = Settings::GetSingleton();
+    gear.candidates.clear();
+    gear.armorRaw = 0;
+    for (const auto& eqObj : proc->equippedForms) {
+        if (!eqObj.object->GetPlayable()) continue;
+        RE::TESBoundObject* form;
+        float weight;
+        if (auto *armor = eqObj.object->As<RE::TESObjectARMO>()) {
+            if (!armor->armorRating && settings->ignoreZeroArmor) continue;
+            gear.armorRaw += armor->armorRating;
+            weight = armor->weight + armor->armorRating * 0.01;
+            form = armor;
+        } else if (auto *weapon = eqObj.object->As<RE::TESObjectWEAP>()) {
+            weight = weapon->weight * (1 + weapon->GetStagger());
+            form = weapon;
+        } else
+            continue;
+        if (weight > 0.0)
+            gear.candidates.emplace_back(form, weight, CanBlock(form));
+    }
+    gear.proc = proc;
+    gear.equipped = equipped;
+    gear.valid = true;
+    return gear;
+}
+
+RE::InventoryEntryData* ActorCache::FindEntry(RE::Actor* actor, RE::TESBoundObject* form)
+{
+    auto inv = actor->GetInventoryChanges();
+    if (!inv || !inv->entryList) return nullptr;
+    auto& index = _actors[actor->GetFormID()].inventory;
+    if (!index.valid || index.inv != inv) {
+        Count(Stats::GetSingleton()->inventoryBuilds);
+        index.entries.Clear();
+        for (auto& entry : *inv->entryList)
+            if (entry && entry->object)
+                if (auto& slot = index.entries[entry->object]; !slot)
+                    slot = entry;
+        index.inv = inv;
+        index.valid = true;
+    }
+    auto found = index.entries.Find(form);
+    return found ? *found : nullptr;
+}
+
+const Resist& ActorCache::GetResist(RE::Actor* actor)
+{
+    const auto* settings = Settings::GetSingleton();
+    auto& resist = _actors[actor->GetFormID()].resist;
+    const auto now = std::chrono::steady_clock::now();
+    if (resist.valid && now - resist.taken < std::chrono::milliseconds(settings->resistRefreshMs)) {
+        Count(Stats::GetSingleton()->resistHits);
+        return resist;
+    }
+    Count(Stats::GetSingleton()->resistRefreshes);
+    resist.damageResist = actor->AsActorValueOwner()->GetActorValue(RE::ActorValue::kDamageResist);
+    resist.destroyResist = settings->DestroyResist(resist.damageResist);
+    resist.taken = now;
+    resist.valid = true;
+    return resist;
+}
+
+WornSlot* ActorCache::FindWorn(RE::Actor* actor, RE::InventoryEntryData* entry, bool left)
+{
+    return _actors[actor->GetFormID()].worn.Find(entry, left, [](RE::InventoryEntryData* entry, bool left) {
+        auto* list = GetWorn(entry->extraLists, left);
+        return std::pair(list, list ? list->GetByType<RE::ExtraHealth>() : nullptr);
+    });
+}
+
+void ActorCache::InvalidateGear(RE::FormID actor)
+{
+    if (auto it = _actors.find(actor); it != _actors.end()) {
+        it->second.gear.valid = false;
+        Count(Stats::GetSingleton()->gearInvalidations);
+    }
+}
+
+void ActorCache::InvalidateInventory(RE::FormID actor)
+{
+    if (auto it = _actors.find(actor); it != _actors.end() && it->second.inventory.valid) {
+        it->second.inventory.valid = false;
+        Count(Stats::GetSingleton()->inventoryInvalidations);
+    }
+}
+
+void ActorCache::InvalidateResist(RE::FormID actor)
+{
+    if (auto it = _actors.find(actor); it != _actors.end())
+        it->second.resist.valid = false;
+}
+
+void ActorCache::InvalidateWorn(RE::FormID actor)
+{
+    if (auto it = _actors.find(actor); it != _actors.end())
+        it->second.worn.valid = false;
+}
+
+void ActorCache::Clear()
+{
+    _actors.clear();
+}
+
+ActorCache *ActorCache::GetSingleton()
+{
+    static ActorCache singleton;
+    return std::addressof(singleton);
+}
+
+std::span<const BaseContainers::Item> BaseContainers::Get(RE::TESContainer* cont)
+{
+    if (!cont) return {};
+    auto& table = _tables[cont];
+    if (table.objects != cont->containerObjects || table.num != cont->numContainerObjects) {
+        Count(Stats::GetSingleton()->containerBuilds);
+        Fill(table, cont);
+    }
+    return table.counts;
+}
+
+std::int32_t BaseContainers::Find(std::span<const Item> counts, const RE::TESBoundObject* form)
+{
+    return FindCount(counts, form);
+}
+
+void BaseContainers::Fill(Table& table, const RE::TESContainer* cont)
+{
+    table.objects = cont->containerObjects;
+    table.num = cont->numContainerObjects;
+    table.counts.clear();
+    for (auto && ent : std::span(cont->containerObjects, cont->numContainerObjects))
+        if (ent && ent->obj)
+            table.counts.emplace_back(ent->obj, ent->count);
+    MergeCounts(table.counts);
+}
+
+void BaseContainers::Build()
+{
+    const auto& npcs = RE::TESDataHandler::GetSingleton()->GetFormArray<RE::TESNPC>();
+    _tables.Reserve(npcs.size());
+    for (auto* npc : npcs)
+        if (npc) Fill(_tables[npc], npc);
+    SKSE::log::info("base containers: {} tables", _tables.Size());
+}
+
+BaseContainers *BaseContainers::GetSingleton()
+{
+    static BaseContainers singleton;
+    return std::addressof(singleton);
+}
+
+void ArmorUpdates::Mark(RE::Actor* actor)
+{
+    Count(Stats::GetSingleton()->armorMarks);
+    const auto id = actor->GetFormID();
+    if (std::find(_dirty.begin(), _dirty.end(), id) == _dirty.end())
+        _dirty.push_back(id);
+    if (!_scheduled) {
+        _scheduled = true;
+        SKSE::GetTaskInterface()->AddTask([]() { ArmorUpdates::GetSingleton()->Flush(); });
+    }
+}
+
+void ArmorUpdates::Flush()
+{
+    _scheduled = false;
+    for (const auto id : _dirty)
+        if (auto actor = RE::TESForm::LookupByID<RE::Actor>(id)) {
+            Count(Stats::GetSingleton()->armorFlushes);
+            actor->AddChange(0x8000420); // 5 10 27
+            actor->OnArmorActorValueChanged();
+        }
+    _dirty.clear();
+}
+
+ArmorUpdates *ArmorUpdates::GetSingleton()
+{
+    static ArmorUpdates singleton;
+    return std::addressof(singleton);
+}
+
+void CombatWear::Add(RE::Actor* actor, RE::TESBoundObject* form, bool left, std::uint8_t flags, float wear, float hits)
+{
+    Count(Stats::GetSingleton()->wearAccumulated);
+    auto& list = _actors[actor->GetFormID()];
+    for (auto& w : list)
+        if (w.form == form && w.left == left) {
+            w.flags = flags;
+            w.wear += wear;
+            w.hits += hits;
+            return;
+        }
+    list.push_back({form, left, flags, wear, hits});
+}
+
+void CombatWear::Flush(RE::FormID id)
+{
+    auto it = _actors.find(id);
+    if (it == _actors.end()) return;
+    // Degrade may remove items and dispatch events, take the list out first
+    const auto list = std::move(it->second);
+    _actors.erase(it);
+    auto actor = RE::TESForm::LookupByID<RE::Actor>(id);
+    if (!actor) return;
+    auto* settings = Settings::GetSingleton();
+    for (const auto& w : list) {
+        Count(Stats::GetSingleton()->wearFlushes);
+        const HitFlags flags(static_cast<RE::TESHitEvent::Flag>(w.flags));
+        settings->Degrade(1.0, actor, w.form, flags, w.left, w.wear / w.hits, w.hits);
+    }
+}
+
+void CombatWear::Clear()
+{
+    _actors.clear();
+}
+
+CombatWear *CombatWear::GetSingleton()
+{
+    static CombatWear singleton;
+    return std::addressof(singleton);
+}
+
+bool ShadowHealth::Due(const Shadow& shadow) const
+{
+    const auto* settings = Settings::GetSingleton();
+    return Due(shadow, settings->writeBackStep, settings->minHealth);
+}
+
+// The item may no longer be worn, so look for the ExtraHealth itself.
+// Returns false only for a shadow restored from the co-save whose item is
+// not in the inventory yet; it is kept for the next sync or save.
+bool ShadowHealth::Write(RE::Actor* actor, RE::TESBoundObject* form, const Shadow& shadow)
+{
+    if (shadow.health == shadow.written) return true;
+    auto entry = ActorCache::GetSingleton()->FindEntry(actor, form);
+    if (!entry || !entry->extraLists) return shadow.extra;
+    for (auto& edl : *entry->extraLists)
+        if (auto extra = edl->GetByType<RE::ExtraHealth>(); Owns(shadow, extra)) {
+            if (ShadowStore::Write(shadow, extra)) ArmorUpdates::GetSingleton()->Mark(actor);
+            return true;
+        }
+    return true;
+}
+
+void ShadowHealth::Sync(RE::Actor* actor, RE::TESBoundObject* form)
+{
+    for (const bool left : {false, true})
+        if (auto shadow = Find(actor->GetFormID(), form->GetFormID(), left))
+            if (Write(actor, form, *shadow)) Erase(actor, form, left);
+}
+
+void ShadowHealth::SyncAll()
+{
+    std::vector<std::uint64_t> done;
+    for (auto& shadows : _shadows) {
+        shadows.ForEach([&](std::uint64_t key, Shadow& shadow) {
+            auto actor = RE::TESForm::LookupByID<RE::Actor>(static_cast<RE::FormID>(key >> 32));
+            auto form = RE::TESForm::LookupByID<RE::TESBoundObject>(static_cast<RE::FormID>(key));
+            if (!actor || !form || Write(actor, form, shadow)) done.push_back(key);
+        });
+        for (const auto key : done) shadows.Erase(key);
+        done.clear();
+    }
+}
+
+ShadowHealth *ShadowHealth::GetSingleton()
+{
+    static ShadowHealth singleton;
+    return std::addressof(singleton);
+}
+
+void InitCaches() {
+    BaseContainers::GetSingleton()->Build();
+}
+
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <chrono>
+#include "FlatMap.h"
+#include "Stats.h"
+#include "WornSlots.h"
+#include "ContainerCounts.h"
+#include "ShadowStore.h"
+
+namespace DurabilityNG {
+
+inline bool CanBlock(RE::TESForm *form) {
+    return form && (
+        form->IsWeapon() || 
+        (form->IsArmor() && form->As<RE::TESObjectARMO>()->IsShield())
+    );
+};
+
+// equipped items the defense stage may pick, with their base pick weight
+struct GearCandidate {
+    RE::TESBoundObject* form;
+    float weight;
+    bool blockable;
+};
+
+struct Gear {
+    std::vector<GearCandidate> candidates;
+    std::uint32_t armorRaw = 0;
+    // the list is rebuilt when the process or its equipment changed
+    const RE::AIProcess* proc = nullptr;
+    std::uint32_t equipped = 0;
+    bool valid = false;
+};
+
+// form -> inventory entry, instead of walking entryList
+struct InventoryIndex {
+    Tools::FlatMap<RE::TESBoundObject*, RE::InventoryEntryData*> entries;
+    const RE::InventoryChanges* inv = nullptr;
+    bool valid = false;
+};
+
+// damage resist and what Settings derives from it; buffs that expire send
+// no event, so a snapshot is also refreshed after Settings::resistRefreshMs
+struct Resist {
+    float damageResist = 0;
+    float destroyResist = 0;
+    std::chrono::steady_clock::time_point taken;
+    bool valid = false;
+};
+
+// Per-actor data derived from engine state, keyed by the actor's FormID and
+// dropped by the event sinks whenever the underlying state changes.
+class ActorCache {
+    public:
+        const Gear& GetGear(RE::Actor* actor, RE::AIProcess* proc);
+        RE::InventoryEntryData* FindEntry(RE::Actor* actor, RE::TESBoundObject* form);
+        const Resist& GetResist(RE::Actor* actor);
+        WornSlot* FindWorn(RE::Actor* actor, RE::InventoryEntryData* entry, bool left);
+
+        void InvalidateGear(RE::FormID actor);
+        void InvalidateInventory(RE::FormID actor);
+        void InvalidateResist(RE::FormID actor);
+        void InvalidateWorn(RE::FormID actor);
+        void Clear();
+
+        static ActorCache* GetSingleton();
+    private:
+        struct Entry {
+            Gear gear;
+            InventoryIndex inventory;
+            Resist resist;
+            WornSlots worn;
+        };
+        std::unordered_map<RE::FormID, Entry> _actors;
+};
+
+// Base container contents merged per form and sorted by form. Base
+// containers do not change after data load, so the tables are built once
+// for every TESNPC; containers first seen later (temporary actor bases) are
+// added on demand and rebuilt if their object array changed.
+class BaseContainers {
+    public:
+        using Item = FormCount<RE::TESBoundObject>;
+
+        std::span<const Item> Get(RE::TESContainer* cont);
+        static std::int32_t Find(std::span<const Item> counts, const RE::TESBoundObject* form);
+
+        void Build();
+
+        static BaseContainers* GetSingleton();
+    private:
+        struct Table {
+            RE::ContainerObject** objects = nullptr;
+            std::uint32_t num = 0;
+            std::vector<Item> counts;
+        };
+        void Fill(Table& table, const RE::TESContainer* cont);
+        Tools::FlatMap<const RE::TESContainer*, Table> _tables;
+};
+
+// Actors whose worn item health changed. AddChange and the armor rating
+// update run once per actor on the next frame instead of after every
+// degrade. Main thread only.
+class ArmorUpdates {
+    public:
+        void Mark(RE::Actor* actor);
+        void Flush();
+
+        static ArmorUpdates* GetSingleton();
+    private:
+        std::vector<RE::FormID> _dirty;
+        bool _scheduled = false;
+};
+
+// Wear from fights between NPCs, summed per (actor, item, hand) and applied
+// with one Degrade when the actor leaves combat or its cell detaches.
+// Main thread only.
+class CombatWear {
+    public:
+        struct Wear {
+            RE::TESBoundObject* form;
+            bool left;
+            std::uint8_t flags; // TESHitEvent flags of the latest hit, for the break chance
+            float wear;         // sum of info * mult * hits
+            float hits;
+        };
+        void Add(RE::Actor* actor, RE::TESBoundObject* form, bool left, std::uint8_t flags, float wear, float hits);
+        void Flush(RE::FormID actor);
+        void Clear();
+
+        template <class F>
+        void ForEach(F&& func) const {
+            for (const auto& [actor, list] : _actors)
+                for (const auto& w : list) func(actor, w);
+        };
+        void Restore(RE::FormID actor, const Wear& wear) { _actors[actor].push_back(wear); };
+
+        static CombatWear* GetSingleton();
+    private:
+        std::unordered_map<RE::FormID, std::vector<Wear>> _actors;
+};
+
+// Health of worn items as the plugin sees it, ahead of ExtraHealth. Degrade
+// writes through only when the change is visible (Settings::writeBackStep);
+// the rest is written on unequip, when an inventory menu opens and before
+// saving; what cannot be written yet is kept in the co-save. Main thread only.
+class ShadowHealth : public ShadowStore<RE::ExtraHealth> {
+    public:
+        using ShadowStore::Get;
+        using ShadowStore::Due;
+        using ShadowStore::Erase;
+        Shadow& Get(RE::Actor* actor, RE::TESBoundObject* form, bool left, RE::ExtraHealth* extra) {
+            return Get(actor->GetFormID(), form->GetFormID(), left, extra);
+        };
+        bool Due(const Shadow& shadow) const;
+        void Erase(RE::Actor* actor, RE::TESBoundObject* form, bool left) {
+            Erase(actor->GetFormID(), form->GetFormID(), left);
+        };
+        void Sync(RE::Actor* actor, RE::TESBoundObject* form);
+        void SyncAll();
+
+        static ShadowHealth* GetSingleton();
+    private:
+        bool Write(RE::Actor* actor, RE::TESBoundObject* form, const Shadow& shadow);
+};
+
+void InitCaches();
+
+}
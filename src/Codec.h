@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace DurabilityNG {
+
+// resolution of health values in the co-save
+inline constexpr float kHealthQuantum = 1.0f / 8192;
+
+// Co-save records are byte streams: counts and FormID deltas as LEB128
+// varints, FormIDs sorted so most deltas fit in one or two bytes.
+class Writer {
+    public:
+        void Varint(std::uint64_t v) {
+            for (; v >= 0x80; v >>= 7) _buf.push_back(static_cast<std::uint8_t>(v | 0x80));
+            _buf.push_back(static_cast<std::uint8_t>(v));
+        };
+        void U8(std::uint8_t v) { _buf.push_back(v); };
+        void U16(std::uint16_t v) { U8(v & 0xFF); U8(v >> 8); };
+        void F32(float v) {
+            const auto u = std::bit_cast<std::uint32_t>(v);
+            U16(u & 0xFFFF); U16(u >> 16);
+        };
+        // health in kHealthQuantum steps, 0..8
+        void Health(float v) {
+            U16(static_cast<std::uint16_t>(std::clamp(std::lround(v / kHealthQuantum), 0l, 0xFFFFl)));
+        };
+
+        const std::vector<std::uint8_t>& Data() const { return _buf; };
+        std::size_t Size() const { return _buf.size(); };
+    private:
+        std::vector<std::uint8_t> _buf;
+};
+
+// reads past the end yield zeros and clear ok
+class Reader {
+    public:
+        explicit Reader(std::vector<std::uint8_t> buf) : _buf(std::move(buf)) {};
+        std::uint64_t Varint() {
+            std::uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const auto b = U8();
+                v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+                if (!(b & 0x80)) break;
+            }
+            return v;
+        };
+        std::uint8_t U8() {
+            if (_pos < _buf.size()) return _buf[_pos++];
+            ok = false;
+            return 0;
+        };
+        std::uint16_t U16() { const std::uint16_t lo = U8(); return lo | U8() << 8; };
+        float F32() { const std::uint32_t lo = U16(); return std::bit_cast<float>(lo | static_cast<std::uint32_t>(U16()) << 16); };
+        float Health() { return U16() * kHealthQuantum; };
+        bool ok = true;
+    private:
+        std::vector<std::uint8_t> _buf;
+        std::size_t _pos = 0;
+};
+
+// (actor, form) pairs in ascending order as deltas: the actor from the
+// previous actor, the form from the previous form of the same actor
+class PairDelta {
+    public:
+        void Write(Writer& out, std::uint32_t actor, std::uint32_t form) {
+            if (actor != _actor) _form = 0;
+            out.Varint(actor - _actor);
+            out.Varint(form - _form);
+            _actor = actor;
+            _form = form;
+        };
+        std::pair<std::uint32_t, std::uint32_t> Read(Reader& in) {
+            const auto da = static_cast<std::uint32_t>(in.Varint());
+            if (da) _form = 0;
+            _actor += da;
+            _form += static_cast<std::uint32_t>(in.Varint());
+            return {_actor, _form};
+        };
+    private:
+        std::uint32_t _actor = 0, _form = 0;
+};
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <vector>
+
+namespace DurabilityNG {
+
+// count of one form in a base container
+template <class Form>
+struct FormCount {
+    Form* form;
+    std::int32_t count;
+};
+
+// sorts by form and merges duplicate forms, so FindCount can binary-search
+template <class Form>
+void MergeCounts(std::vector<FormCount<Form>>& counts) {
+    std::sort(counts.begin(), counts.end(),
+        [](const FormCount<Form>& a, const FormCount<Form>& b) { return a.form < b.form; });
+    auto out = counts.begin();
+    for (auto it = counts.begin(); it != counts.end(); ++it)
+        if (out != counts.begin() && std::prev(out)->form == it->form)
+            std::prev(out)->count += it->count;
+        else
+            *out++ = *it;
+    counts.erase(out, counts.end());
+    counts.shrink_to_fit();
+}
+
+template <class Form>
+std::int32_t FindCount(std::span<const FormCount<Form>> counts, const Form* form) {
+    auto it = std::lower_bound(counts.begin(), counts.end(), form,
+        [](const FormCount<Form>& c, const Form* f) { return c.form < f; });
+    return it != counts.end() && it->form == form ? it->count : 0;
+}
+
+}
@@ -1,67 +1,91 @@
 ﻿#undef GetObject
 
 #include "Events.h"
+#include "Cache.h"
+#include "Pick.h"
+#include "Arena.h"
 #include "Settings.h"
 #include "Tools.h"
+#include "RingBuffer.h"
+#include "Sampling.h"
+#include "Throttle.h"
+#include "Stats.h"
 
 namespace DurabilityNG {
 
-inline bool CanBlock(RE::TESForm *form) {
-    return form && (
-        form->IsWeapon() || 
-        (form->IsArmor() && form->As<RE::TESObjectARMO>()->IsShield())
-    );
+inline RE::Actor* AsActor(const RE::NiPointer<RE::TESObjectREFR>& ref) {
+	return ref ? ref->As<RE::Actor>() : nullptr;
 };
 
-template <class T>
-class PickOne {
-	public:
-		inline bool Has() { return _weight > 0.0; };
-		inline T Get(T fallback) { return Has() ? _curr : fallback; };
-		inline void Push(T cand, float weight = 1.0) {
-			_weight += weight;
-			if (Tools::RandU<float>(_weight) < weight) _curr = cand;
-		};
-	private:
-		T _curr;
-		double _weight = 0;
+// what the stages need from a TESHitEvent, with the references resolved
+struct Hit {
+	RE::Actor* attacker;
+	RE::Actor* defender;
+	RE::FormID source;
+	RE::FormID projectile;
+	HitFlags flags;
+};
+
+// copy of a TESHitEvent kept in the queue until the next frame
+struct HitRecord {
+	RE::ObjectRefHandle cause;
+	RE::ObjectRefHandle target;
+	RE::FormID source = 0;
+	RE::FormID projectile = 0;
+	HitFlags flags;
 };
 
-template <class T, typename W = float>
-class PickList {
+// Items the destroy stage decided to remove. Removals of the same form from
+// the same actor are merged and applied with one RemoveItem call at the end
+// of the event, or of the whole drain in deferred mode.
+class RemovalBatch {
 	public:
-		inline double weightSum() { return _weightSum; };
-		inline void Push(const T&& val, const W& w) {
-			if (w > 0.0) {
-				_entries.emplace_back(val, w);
-				_weightSum += w;
-			}
+		inline void Add(RE::Actor* actor, RE::TESBoundObject* form, std::int32_t count) {
+			const auto id = actor->GetFormID();
+			for (auto& rem : _removals)
+				if (rem.actor == id && rem.form == form) {
+					rem.count += count;
+					Count(Stats::GetSingleton()->removalsMerged);
+					return;
+				}
+			_removals.emplace_back(id, form, count);
 		};
 
-		inline T* Pull(W* weight1 = nullptr) {
-			if (0.0 < _weightSum) {
-				auto v = Tools::RandU(_weightSum);
+		// already claimed by earlier hits of this batch
+		inline std::int32_t Pending(const RE::Actor* actor, const RE::TESBoundObject* form) const {
+			if (_removals.empty()) return 0;
+			const auto id = actor->GetFormID();
+			for (const auto& rem : _removals)
+				if (rem.actor == id && rem.form == form) return rem.count;
+			return 0;
+		};
 
-				for (auto& [item, w]: _entries) {
-					if (v < w) {
-						_weightSum -= w;
-						if (weight1) *weight1 = w;
-						w = 0;
-						return &item;
-					}
-					v -= w;
+		void Apply() {
+			// by index: RemoveItem may dispatch events that add to the batch
+			for (std::size_t i = 0; i < _removals.size(); i++)
+				if (const auto rem = _removals[i]; auto actor = RE::TESForm::LookupByID<RE::Actor>(rem.actor)) {
+					Count(Stats::GetSingleton()->removeItemCalls);
+					actor->RemoveItem(rem.form, rem.count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);
 				}
-			}
-			return nullptr;
+			_removals.clear();
 		};
 
-		PickList(unsigned int reserve = 0) {
-			_entries.reserve(reserve);
+	private:
+		struct Removal {
+			RE::FormID actor;
+			RE::TESBoundObject* form;
+			std::int32_t count;
 		};
+		std::vector<Removal> _removals;
+};
 
-	private:
-		std::vector<std::pair<T, W>> _entries = {};
-		double _weightSum = 0;
+// what closing a swing window needs to degrade the weapon
+struct Swing {
+	RE::TESBoundObject* form;
+	bool left;
+	std::uint8_t flags;
+	GroupActorInfo info;
+	bool aggregate;
 };
 
 class HitEventHandler : public RE::BSTEventSink<RE::TESHitEvent> {
@@ -72,18 +96,127 @@ public:
     }
 
     RE::BSEventNotifyControl ProcessEvent(const RE::TESHitEvent* event, RE::BSTEventSource<RE::TESHitEvent>* eventSource) override {
-		if (!event) return RE::BSEventNotifyControl::kContinue;
+		if (!event || !_process) return RE::BSEventNotifyControl::kContinue;
+
+		if (Settings::GetSingleton()->deferHits) {
+			HitRecord rec{
+				event->cause ? event->cause->GetHandle() : RE::ObjectRefHandle{},
+				event->target ? event->target->GetHandle() : RE::ObjectRefHandle{},
+				event->source, event->projectile, event->flags
+			};
+			if (_queue.TryPush(rec)) {
+				Count(Stats::GetSingleton()->hitsQueued);
+				if (!_scheduled.exchange(true))
+					SKSE::GetTaskInterface()->AddTask(Drain);
+				return RE::BSEventNotifyControl::kContinue;
+			}
+			Count(Stats::GetSingleton()->hitsOverflow);
+		}
 
+		_process({AsActor(event->cause), AsActor(event->target), event->source, event->projectile, event->flags});
+		_removals.Apply();
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+	// Runs once per frame through the task interface. Hits involving the
+	// player are processed right away; the rest share the per-frame budget
+	// and carry over to the next frame. A player hit whose opponent still has
+	// carried-over work waits behind it, so each actor sees its hits in order.
+	// The carry-over is capped at MaxBacklog: a late hit reads the attacker's
+	// current attack state and hand, which have moved on after a few frames.
+	static void Drain() {
+		_scheduled.store(false);
+		auto* stats = Stats::GetSingleton();
+		Count(stats->drains);
+
+		const auto player = RE::PlayerCharacter::GetSingleton()->GetHandle().native_handle();
+		HitRecord rec;
+		while (_queue.TryPop(rec)) {
+			const auto cause = rec.cause.native_handle();
+			const auto target = rec.target.native_handle();
+			if ((cause == player || target == player) && !Pending(cause) && !Pending(target))
+				_priority.push_back(rec);
+			else {
+				AddPending(cause, 1);
+				AddPending(target, 1);
+				_background.push_back(rec);
+			}
+		}
+
+		Count(stats->priorityHits, _priority.size());
+		for (const auto& hit : _priority)
+			Run(hit);
+		_priority.clear();
+
+		const auto* settings = Settings::GetSingleton();
+		const std::chrono::microseconds budget(settings->frameBudgetUs);
+		const std::size_t cap = settings->maxBacklog ? settings->maxBacklog : SIZE_MAX;
+		const auto start = std::chrono::steady_clock::now();
+		bool over = false;
+		while (!_background.empty()) {
+			rec = _background.front();
+			_background.pop_front();
+			AddPending(rec.cause.native_handle(), -1);
+			AddPending(rec.target.native_handle(), -1);
+			Run(rec);
+			if (over) Count(stats->backlogOverruns);
+			else if (budget.count() && std::chrono::steady_clock::now() - start >= budget) over = true;
+			if (over && _background.size() <= cap) break;
+		}
+		_removals.Apply();
+
+		if (!_background.empty()) {
+			Count(stats->deferredHits, _background.size());
+			CountMax(stats->maxBacklog, _background.size());
+			if (!_scheduled.exchange(true))
+				SKSE::GetTaskInterface()->AddTask(Drain);
+		}
+	}
+
+	static void Run(const HitRecord& rec) {
+		const auto cause = rec.cause.get();
+		const auto target = rec.target.get();
+		if (_process) _process({AsActor(cause), AsActor(target), rec.source, rec.projectile, rec.flags});
+	}
+
+	static std::uint32_t Pending(std::uint32_t handle) {
+		const auto* n = _pending.Find(handle);
+		return n ? *n : 0;
+	}
+
+	static void AddPending(std::uint32_t handle, int delta) {
+		if (!handle) return;
+		auto& n = _pending[handle];
+		n += delta;
+		if (!n) _pending.Erase(handle);
+	}
+
+	// One instantiation per combination of enabled stages, so a disabled
+	// stage costs nothing per hit. Select() picks the variant after the
+	// settings are loaded.
+	template <bool Attack, bool Defense, bool Destroy, bool Message>
+	static void Process(const Hit& hit) {
 		auto* settings = DurabilityNG::Settings::GetSingleton();
 		bool is_magic = false;
 
-		const auto& attacker = event->cause->As<RE::Actor>();
-		const auto& defender = event->target->As<RE::Actor>();
+		const auto& attacker = hit.attacker;
+		const auto& defender = hit.defender;
+		if (!attacker || !defender) return;
+		const auto traits = GetActorTraits(attacker);
+		const bool npcs = (settings->aggregateNPC || !settings->subsampleBands.empty())
+			&& !(traits & (kPlayer | kTeammate)) && !(GetActorTraits(defender) & (kPlayer | kTeammate));
+		const float hits = npcs ? Subsample(attacker, defender) : 1.0f;
+		if (!hits) return;
+		const bool aggregate = npcs && settings->aggregateNPC;
+		[[maybe_unused]] float defenseHits = hits;
+		if constexpr (Defense || Destroy)
+			if (settings->hitRate > 0.0f)
+				defenseHits = _limiter.Take(defender->GetFormID(), hits, std::chrono::steady_clock::now(), settings->hitRate, settings->hitBurst);
 
-		do {
-			if (event->projectile) break;
-			if (!event->source) break;
-			const auto& info = settings->Attack.ActorInfo(attacker, event->flags);
+		if constexpr (Attack) do {
+			if (hit.projectile) break;
+			if (!hit.source) break;
+			const auto& info = settings->Attack.ActorInfo(traits, hit.flags.underlying());
 			if (!info) break;
 			const auto& proc = attacker->GetActorRuntimeData().currentProcess;
 			if (!proc) break;
@@ -94,46 +227,53 @@ public:
 			bool left = proc->high->attackData->IsLeftAttack(); // definition may be wrong
 			attacker->GetGraphVariableBool("bLeftHandAttack", left);
 			const auto& entry = left ? proc->middleHigh->leftHand : proc->middleHigh->rightHand;
-			settings->Degrade(info, attacker, entry, event->flags, left);
+			if (settings->multiHitWindowMs) {
+				if (entry && entry->object) {
+					_swings.Hit(attacker->GetFormID(), hit.source, {entry->object, left, hit.flags.underlying(), info, aggregate},
+						hits, settings->multiHitFactor, std::chrono::steady_clock::now(),
+						std::chrono::milliseconds(settings->multiHitWindowMs), CloseSwing);
+					ScheduleSweep();
+				}
+				break;
+			}
+			if (aggregate) {
+				if (entry && entry->object)
+					CombatWear::GetSingleton()->Add(attacker, entry->object, left, hit.flags.underlying(), info * hits, hits);
+			} else
+				settings->Degrade(info, attacker, entry, hit.flags, left, 1.0f, hits);
 		} while(false);
 
-		if (const auto& info = settings->Defense.ActorInfo(attacker, event->flags))
+		if constexpr (Defense)
+		if (defenseHits)
+		if (const auto& info = settings->Defense.ActorInfo(traits, hit.flags.underlying()))
 			if (const auto& proc = defender->GetActorRuntimeData().currentProcess) {
-				PickOne<RE::TESForm *> pick;
-				bool blocked = event->flags.any(RE::TESHitEvent::Flag::kHitBlocked);
-				uint32_t armorRaw = 0;
-				for (const auto& eqObj : proc->equippedForms) {
-					if (!eqObj.object->GetPlayable()) continue;
-					float weight;
-					if (const auto *armor = eqObj.object->As<RE::TESObjectARMO>()) {
-						if (!armor->armorRating && settings->ignoreZeroArmor) continue;
-						armorRaw += armor->armorRating;
-						weight = armor->weight + armor->armorRating * 0.01;
-					} else if (const auto *weapon = eqObj.object->As<RE::TESObjectWEAP>())
-        				weight = weapon->weight * (1 + weapon->GetStagger());
-					else
-						continue;
-					if (blocked && !CanBlock(eqObj.object))
+				const auto& gear = ActorCache::GetSingleton()->GetGear(defender, proc);
+				PickOnePrefix<RE::TESBoundObject *> pick;
+				bool blocked = hit.flags.any(RE::TESHitEvent::Flag::kHitBlocked);
+				for (const auto& cand : gear.candidates) {
+					float weight = cand.weight;
+					if (blocked && !cand.blockable)
 						weight *= settings->blockedHitOther;
 					if (weight > 0.0)
-						pick.Push(eqObj.object, weight);
+						pick.Push(cand.form, weight);
 				}
 
-				if (pick.Has())
-					if (auto inv = defender->GetInventoryChanges(); inv && inv->entryList)
-						for (auto& entry : *inv->entryList)
-							if (entry && entry->object == pick.Get(NULL)) {
-								bool left = blocked && CanBlock(entry->object);
-								float mult = armorRaw * 0.01 / defender->AsActorValueOwner()->GetActorValue(RE::ActorValue::kDamageResist);
-								settings->Degrade(info, defender, entry, event->flags, left, mult);
-								break;
-							}
+				if (pick.Has()) {
+					auto form = pick.Get(nullptr);
+					bool left = blocked && CanBlock(form);
+					float mult = gear.armorRaw * 0.01 / ActorCache::GetSingleton()->GetResist(defender).damageResist;
+					if (aggregate)
+						CombatWear::GetSingleton()->Add(defender, form, left, hit.flags.underlying(), info * mult * defenseHits, defenseHits);
+					else
+						settings->Degrade(info, defender, form, hit.flags, left, mult, defenseHits);
+				}
 			}
 		
-		do {
-			const auto& info = settings->Destroy.ActorInfo(attacker, event->flags);
-			if (!info) break;
-			if (!(info >= 1.0 || info > Tools::RandU<float>())) break;
+		if constexpr (Destroy) do {
+			if (!defenseHits) break;
+			// up to one roll per hit this one stands for
+			auto rolls = DestroyRolls(settings->Destroy.ActorInfo(traits, hit.flags.underlying()), defenseHits);
+			if (!rolls) break;
 			auto invCh = defender->GetInventoryChanges();
 			if (!invCh) break;
 			auto weight = invCh->totalWeight - invCh->armorWeight;
@@ -143,86 +283,312 @@ public:
 				if (proc->middleHigh->rightHand) weight -= proc->middleHigh->rightHand->GetWeight();
 			}
 			if (!(weight > 0.0)) break;
-			auto resist = settings->DestroyResist(attacker);
+			auto resist = ActorCache::GetSingleton()->GetResist(attacker).destroyResist;
 			if (resist > weight) break;
-			if (resist > Tools::RandU(weight)) break;
-		
-			std::map<RE::TESBoundObject*, std::int32_t> counts{};
-			if (auto cont = defender->GetContainer())
-				for (auto && ent : std::span(cont->containerObjects, cont->numContainerObjects)) {
-					const auto& [it, added] = counts.try_emplace(ent->obj, ent->count);
-					if (!added) it->second += ent->count;
-				}
-			
-			struct Item { RE::TESBoundObject* form; std::int32_t count; };
-			auto pick = PickList<Item>(defender->IsPlayer() ? 100 : 20);
-			if (invCh->entryList)
-				for (auto &entry : *invCh->entryList) {
-					if (entry->IsQuestObject()) continue;
-					if (entry->IsLeveled()) continue;
-					const auto& obj = entry->object;
-					auto num = entry->countDelta;
-					if (auto it = counts.find(obj); it != counts.end())
-						num += it->second;
-					if (entry->extraLists && (obj->IsArmor() || obj->IsWeapon()))
-						for (auto &edl : *entry->extraLists) {
-							if (edl->HasType<RE::ExtraWorn>()) num--;
-							if (edl->HasType<RE::ExtraWornLeft>()) num--;							
-						}
-					if (num > 0) {
-						auto w = settings->DestroyWeight(obj) * num;
-						if (entry->IsFavorited()) w *= settings->destroyFavorite;
-						pick.Push({obj, num}, w);
+			for (; rolls; rolls--) {
+				if (resist > Tools::RandU(weight)) continue;
+				Count(Stats::GetSingleton()->destroyEvents);
+				Tools::Arena arena;
+				// LinearPick for the player too: a roll stops after a few pulls,
+				// and FenwickPick's O(n) tree build only pays off when most of a
+				// large list is drained (PickListBench)
+				if (defender->IsPlayer())
+					DestroyItems<LinearPick, Message>(defender, invCh, weight, resist, 100, arena.get());
+				else
+					DestroyItems<LinearPick, false>(defender, invCh, weight, resist, 20, arena.get());
+			}
+		} while (false);
+    }
+
+	// one weapon degrade for all hits of a swing, wear in units of one hit
+	static void CloseSwing(RE::FormID id, const Swing& swing, float wear, float hits) {
+		auto attacker = RE::TESForm::LookupByID<RE::Actor>(id);
+		if (!attacker) return;
+		if (swing.aggregate)
+			CombatWear::GetSingleton()->Add(attacker, swing.form, swing.left, swing.flags, swing.info * wear, hits);
+		else {
+			const HitFlags flags(static_cast<RE::TESHitEvent::Flag>(swing.flags));
+			Settings::GetSingleton()->Degrade(swing.info, attacker, swing.form, flags, swing.left, wear / hits, hits);
+		}
+	}
+
+	// closes the swing windows that ran out, once per frame while any is open
+	static void Sweep() {
+		_sweepScheduled = false;
+		_swings.Expire(std::chrono::steady_clock::now(),
+			std::chrono::milliseconds(Settings::GetSingleton()->multiHitWindowMs), CloseSwing);
+		if (_swings.Open()) ScheduleSweep();
+	}
+
+	static void ScheduleSweep() {
+		if (!std::exchange(_sweepScheduled, true))
+			SKSE::GetTaskInterface()->AddTask(Sweep);
+	}
+
+	// Distant fights between NPCs are only processed for a random fraction p
+	// of their hits (see [Subsample]). Returns how many hits the processed
+	// one stands for, 1/p, or 0 to skip it; expected wear stays the same.
+	static float Subsample(const RE::Actor* attacker, const RE::Actor* defender) {
+		const auto* settings = Settings::GetSingleton();
+		if (settings->subsampleBands.empty()) return 1.0f;
+		const auto& pos = RE::PlayerCharacter::GetSingleton()->GetPosition();
+		const float dist = std::min(attacker->GetPosition().GetDistance(pos), defender->GetPosition().GetDistance(pos));
+		const float hits = SubsampleWeight(settings->SubsampleFraction(dist));
+		if (!hits) Count(Stats::GetSingleton()->hitsSubsampled);
+		return hits;
+	}
+
+	// pulls weighted inventory items until the resist roll stops it
+	template <class Policy, bool Message>
+	static void DestroyItems(RE::Actor* defender, RE::InventoryChanges* invCh, float weight, float resist, unsigned int reserve, std::pmr::memory_resource* mr) {
+		auto* settings = DurabilityNG::Settings::GetSingleton();
+		const auto counts = BaseContainers::GetSingleton()->Get(defender->GetContainer());
+
+		struct Item { RE::TESBoundObject* form; std::int32_t count; };
+		auto pick = PickList<Item, float, Policy>(reserve, mr);
+		if (invCh->entryList)
+			for (auto &entry : *invCh->entryList) {
+				if (entry->IsQuestObject()) continue;
+				if (entry->IsLeveled()) continue;
+				const auto& obj = entry->object;
+				auto num = entry->countDelta + BaseContainers::Find(counts, obj) - _removals.Pending(defender, obj);
+				if (entry->extraLists && (obj->IsArmor() || obj->IsWeapon()))
+					for (auto &edl : *entry->extraLists) {
+						if (edl->HasType<RE::ExtraWorn>()) num--;
+						if (edl->HasType<RE::ExtraWornLeft>()) num--;							
 					}
+				if (num > 0) {
+					auto w = settings->DestroyWeight(obj) * num;
+					if (entry->IsFavorited()) w *= settings->destroyFavorite;
+					pick.Push({obj, num}, w);
 				}
+			}
 
-				
-			bool message = settings->destroyMessage && defender->IsPlayer();
-			int32_t more = 0;
-			std::string msg = "";
-			if (message)
-				msg.reserve(30 + std::min(100u, settings->destroyMessage));
-			while (auto item = pick.Pull()) {
-				weight -= item->form->GetWeight() * item->count;
-				if((item->count = Tools::RandU(item->count))) { // TODO? add exponent (default 2)
-					if (message) {
-						if (msg.size() > settings->destroyMessage)
+		int32_t more = 0;
+		std::pmr::string msg{mr};
+		if constexpr (Message)
+			msg.reserve(30 + std::min(100u, settings->destroyMessage));
+		while (auto item = pick.Pull()) {
+			weight -= item->form->GetWeight() * item->count;
+			if((item->count = Tools::RandU(item->count))) { // TODO? add exponent (default 2)
+				if constexpr (Message) {
+					if (msg.size() > settings->destroyMessage)
+						more += item->count;
+					else {
+						auto name = item->form->GetName();
+						if (name && name[0]) {
+							if (!msg.empty()) msg += ", ";
+							if (item->count > 1) std::format_to(std::back_inserter(msg), "{} ", item->count);
+							msg += name;
+						} else
 							more += item->count;
-						else {
-							auto name = item->form->GetName();
-							if (name && name[0]) {
-								if (!msg.empty()) msg += ", ";
-								if (item->count > 1) msg += std::to_string(item->count) + " ";
-								msg += name;
-							} else
-								more += item->count;
-						}
 					}
-					defender->RemoveItem(item->form, item->count, RE::ITEM_REMOVE_REASON::kRemove, nullptr, nullptr);				
 				}
-				if (resist > Tools::RandU(weight)) break;
-			}
-			if (more) {
-				if (!msg.empty()) msg += ", and ";
-				msg += std::to_string(more) + " items";
-			}
-			if (message && msg.size()) {
-				msg.insert(0, "Destroyed ");
-				RE::DebugNotification(msg.c_str());
+				_removals.Add(defender, item->form, item->count);
 			}
+			if (resist > Tools::RandU(weight)) break;
+		}
+		if (more) {
+			if (!msg.empty()) msg += ", and ";
+			std::format_to(std::back_inserter(msg), "{} items", more);
+		}
+		if (Message && msg.size()) {
+			msg.insert(0, "Destroyed ");
+			RE::DebugNotification(msg.c_str());
+		}
+	}
 
-		} while (false);
-		
-        return RE::BSEventNotifyControl::kContinue;
+	using ProcessFn = void (*)(const Hit&);
+
+	// nullptr when every stage is off
+	static ProcessFn Select() {
+		const auto* settings = Settings::GetSingleton();
+		const std::size_t i =
+			(settings->Attack.Enabled()  ? 1 : 0) |
+			(settings->Defense.Enabled() ? 2 : 0) |
+			(settings->Destroy.Enabled() ? 4 : 0) |
+			(settings->destroyMessage    ? 8 : 0);
+		if (!(i & 7)) return nullptr;
+		return Variants(std::make_index_sequence<16>{})[i];
+	}
+
+	template <std::size_t... I>
+	static constexpr std::array<ProcessFn, sizeof...(I)> Variants(std::index_sequence<I...>) {
+		return {&Process<!!(I & 1), !!(I & 2), !!(I & 4), !!(I & 8)>...};
+	}
+
+    static void Register() {
+		_process = Select();
+        RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(GetSingleton());
+    }
+
+	// the actors of open swing windows are gone after a load, and runtime
+	// FormIDs are reused by the next game
+	static void Revert() {
+		_swings.Clear();
+		_limiter.Clear();
+	}
+
+private:
+	static inline ProcessFn _process = nullptr;
+	static inline RemovalBatch _removals;
+	static inline SwingFilter<Swing> _swings;
+	static inline bool _sweepScheduled = false;
+	static inline HitLimiter _limiter;
+	static inline Tools::RingBuffer<HitRecord, 4096> _queue;
+	static inline std::vector<HitRecord> _priority;
+	static inline std::deque<HitRecord> _background;
+	static inline Tools::FlatMap<std::uint32_t, std::uint32_t> _pending; // background hits per actor handle
+	static inline std::atomic<bool> _scheduled = false;
+};
+
+class EquipEventHandler : public RE::BSTEventSink<RE::TESEquipEvent> {
+public:
+	static EquipEventHandler* GetSingleton() {
+        static EquipEventHandler singleton;
+        return &singleton;
     }
 
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESEquipEvent* event, RE::BSTEventSource<RE::TESEquipEvent>* eventSource) override {
+		if (event && event->actor) {
+			if (!event->equipped)
+				if (auto actor = AsActor(event->actor))
+					if (auto form = RE::TESForm::LookupByID<RE::TESBoundObject>(event->baseObject))
+						ShadowHealth::GetSingleton()->Sync(actor, form);
+			auto* cache = ActorCache::GetSingleton();
+			cache->InvalidateGear(event->actor->GetFormID());
+			cache->InvalidateResist(event->actor->GetFormID());
+			cache->InvalidateWorn(event->actor->GetFormID());
+		}
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
     static void Register() {
         RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(GetSingleton());
     }
+};
 
+class ContainerChangedEventHandler : public RE::BSTEventSink<RE::TESContainerChangedEvent> {
+public:
+	static ContainerChangedEventHandler* GetSingleton() {
+        static ContainerChangedEventHandler singleton;
+        return &singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESContainerChangedEvent* event, RE::BSTEventSource<RE::TESContainerChangedEvent>* eventSource) override {
+		if (event) {
+			auto* cache = ActorCache::GetSingleton();
+			for (const auto id : {event->oldContainer, event->newContainer})
+				if (id) {
+					cache->InvalidateInventory(id);
+					cache->InvalidateWorn(id);
+				}
+		}
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+    static void Register() {
+        RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(GetSingleton());
+    }
+};
+
+class MagicEffectApplyEventHandler : public RE::BSTEventSink<RE::TESMagicEffectApplyEvent> {
+public:
+	static MagicEffectApplyEventHandler* GetSingleton() {
+        static MagicEffectApplyEventHandler singleton;
+        return &singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESMagicEffectApplyEvent* event, RE::BSTEventSource<RE::TESMagicEffectApplyEvent>* eventSource) override {
+		if (!event || !event->target) return RE::BSEventNotifyControl::kContinue;
+		// only effects on damage resist (armor spells, potions, enchantments)
+		// change the snapshot
+		const auto* effect = RE::TESForm::LookupByID<RE::EffectSetting>(event->magicEffect);
+		if (effect && (effect->data.primaryAV == RE::ActorValue::kDamageResist || effect->data.secondaryAV == RE::ActorValue::kDamageResist))
+			ActorCache::GetSingleton()->InvalidateResist(event->target->GetFormID());
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+    static void Register() {
+        RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(GetSingleton());
+    }
 };
 
+// applies the accumulated CombatWear when an actor leaves combat
+class CombatEventHandler : public RE::BSTEventSink<RE::TESCombatEvent> {
+public:
+	static CombatEventHandler* GetSingleton() {
+        static CombatEventHandler singleton;
+        return &singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESCombatEvent* event, RE::BSTEventSource<RE::TESCombatEvent>* eventSource) override {
+		if (event && event->actor && event->newState.get() == RE::ACTOR_COMBAT_STATE::kNone)
+			CombatWear::GetSingleton()->Flush(event->actor->GetFormID());
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+    static void Register() {
+        RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(GetSingleton());
+    }
+};
+
+// ... or when its cell detaches while still in combat
+class CellAttachDetachEventHandler : public RE::BSTEventSink<RE::TESCellAttachDetachEvent> {
+public:
+	static CellAttachDetachEventHandler* GetSingleton() {
+        static CellAttachDetachEventHandler singleton;
+        return &singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::TESCellAttachDetachEvent* event, RE::BSTEventSource<RE::TESCellAttachDetachEvent>* eventSource) override {
+		if (event && event->reference && !event->attached)
+			CombatWear::GetSingleton()->Flush(event->reference->GetFormID());
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+    static void Register() {
+        RE::ScriptEventSourceHolder::GetSingleton()->AddEventSink(GetSingleton());
+    }
+};
+
+// writes the shadow health back before the player can look at it
+class MenuOpenCloseEventHandler : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
+public:
+	static MenuOpenCloseEventHandler* GetSingleton() {
+        static MenuOpenCloseEventHandler singleton;
+        return &singleton;
+    }
+
+    RE::BSEventNotifyControl ProcessEvent(const RE::MenuOpenCloseEvent* event, RE::BSTEventSource<RE::MenuOpenCloseEvent>* eventSource) override {
+		if (event && event->opening && (
+			event->menuName == RE::InventoryMenu::MENU_NAME ||
+			event->menuName == RE::ContainerMenu::MENU_NAME ||
+			event->menuName == RE::BarterMenu::MENU_NAME ||
+			event->menuName == RE::GiftMenu::MENU_NAME))
+			ShadowHealth::GetSingleton()->SyncAll();
+		return RE::BSEventNotifyControl::kContinue;
+	}
+
+    static void Register() {
+        RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(GetSingleton());
+    }
+};
+
+void RevertEvents() {
+	HitEventHandler::Revert();
+}
+
 void InitEvents() {
 	HitEventHandler::Register();
+	EquipEventHandler::Register();
+	ContainerChangedEventHandler::Register();
+	MagicEffectApplyEventHandler::Register();
+	if (Settings::GetSingleton()->aggregateNPC) {
+		CombatEventHandler::Register();
+		CellAttachDetachEventHandler::Register();
+	}
+	if (Settings::GetSingleton()->writeBackStep > 0.0)
+		MenuOpenCloseEventHandler::Register();
 }
 }
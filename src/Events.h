@@ -2,4 +2,5 @@
 
 namespace DurabilityNG {
 	void InitEvents();
+	void RevertEvents();
 }
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace Tools {
+
+    // Open-addressing hash map for pointer and integer keys (linear probing,
+    // Fibonacci hashing, backward-shift erase). The value-initialized key
+    // (nullptr / 0) marks an empty slot and cannot be stored.
+    template <class K, class V>
+    class FlatMap {
+        static_assert(std::is_pointer_v<K> || std::is_integral_v<K>, "pointer or integer keys only");
+        public:
+            inline V* Find(K key) {
+                if (!_size) return nullptr;
+                for (auto i = Index(key);; i = (i + 1) & _mask) {
+                    auto& slot = _slots[i];
+                    if (slot.key == key) return &slot.val;
+                    if (slot.key == K{}) return nullptr;
+                }
+            };
+
+            inline const V* Find(K key) const {
+                return const_cast<FlatMap*>(this)->Find(key);
+            };
+
+            inline V& operator[](K key) {
+                if ((_size + 1) * 2 > _slots.size()) Rehash(_slots.size() ? _slots.size() * 2 : 16);
+                auto i = Index(key);
+                for (; _slots[i].key != K{}; i = (i + 1) & _mask)
+                    if (_slots[i].key == key) return _slots[i].val;
+                _size++;
+                _slots[i].key = key;
+                _slots[i].val = V{};
+                return _slots[i].val;
+            };
+
+            inline bool Erase(K key) {
+                if (!_size) return false;
+                auto i = Index(key);
+                for (; _slots[i].key != key; i = (i + 1) & _mask)
+                    if (_slots[i].key == K{}) return false;
+                // shift following entries back so no probe chain is broken
+                for (auto j = (i + 1) & _mask; _slots[j].key != K{}; j = (j + 1) & _mask) {
+                    const auto home = Index(_slots[j].key);
+                    if (((j - home) & _mask) >= ((j - i) & _mask)) {
+                        _slots[i] = std::move(_slots[j]);
+                        i = j;
+                    }
+                }
+                _slots[i].key = K{};
+                _slots[i].val = V{};
+                _size--;
+                return true;
+            };
+
+            template <class F>
+            inline void ForEach(F&& func) {
+                for (auto& slot : _slots)
+                    if (slot.key != K{}) func(slot.key, slot.val);
+            };
+
+            inline void Clear() {
+                for (auto& slot : _slots) slot = Slot{};
+                _size = 0;
+            };
+
+            inline void Reserve(std::size_t n) {
+                std::size_t cap = 16;
+                while (cap < n * 2) cap *= 2;
+                if (cap > _slots.size()) Rehash(cap);
+            };
+
+            inline std::size_t Size() const { return _size; };
+
+        private:
+            struct Slot {
+                K key{};
+                V val{};
+            };
+
+            inline std::size_t Index(K key) const {
+                std::uint64_t h;
+                if constexpr (std::is_pointer_v<K>)
+                    h = reinterpret_cast<std::uintptr_t>(key);
+                else
+                    h = static_cast<std::uint64_t>(key);
+                return static_cast<std::size_t>((h * 0x9E3779B97F4A7C15ull) >> _shift);
+            };
+
+            void Rehash(std::size_t cap) {
+                auto old = std::move(_slots);
+                _slots.assign(cap, Slot{});
+                _mask = cap - 1;
+                _shift = 64;
+                for (auto c = cap; c > 1; c >>= 1) _shift--;
+                for (auto& slot : old)
+                    if (slot.key != K{}) {
+                        auto i = Index(slot.key);
+                        while (_slots[i].key != K{}) i = (i + 1) & _mask;
+                        _slots[i] = std::move(slot);
+                    }
+            };
+
+            std::vector<Slot> _slots;
+            std::size_t _size = 0;
+            std::size_t _mask = 0;
+            int _shift = 64;
+    };
+
+}
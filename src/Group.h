@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include "SimpleIni.h"
+
+namespace RE { class Actor; }
+
+namespace DurabilityNG {
+
+using GroupActorInfo = float;
+constexpr float fNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float fInf = std::numeric_limits<float>::infinity();
+
+// the actor properties Group::ActorInfo depends on
+using ActorTraits = std::uint32_t;
+enum ActorTrait : ActorTraits {
+    kPlayer    = 1 << 0,
+    kTeammate  = 1 << 1,
+    kEssential = 1 << 2,
+    kProtected = 1 << 3,
+    kUnique    = 1 << 4,
+    kRespawns  = 1 << 5,
+    kTraitBits = 6
+};
+ActorTraits GetActorTraits(const RE::Actor* target);
+
+// the TESHitEvent::Flag bits Group::ActorInfo depends on (checked against
+// the engine enum in Settings.cpp)
+enum HitFlagBit : std::uint8_t {
+    kHitPower   = 1 << 0,
+    kHitSneak   = 1 << 1,
+    kHitBash    = 1 << 2,
+    kHitBlocked = 1 << 3
+};
+
+class Group {
+    public:
+        Group() { Compile(); };
+        GroupActorInfo ActorInfo(const RE::Actor* target, std::uint8_t flags);
+        inline GroupActorInfo ActorInfo(ActorTraits traits, std::uint8_t flags) const {
+            return _table[traits << 4 | (flags & 0xF)];
+        };
+        // false if no actor or hit flag combination yields a nonzero value
+        inline bool Enabled() const { return _enabled; };
+        void Load(CSimpleIniA& ini, const char * section);
+    private:
+        float Evaluate(ActorTraits traits, std::uint8_t flags) const;
+        void Compile();
+        // every traits / hit flag combination, filled by Load
+        std::array<GroupActorInfo, 1 << (kTraitBits + 4)> _table{};
+        bool _enabled = false;
+
+        float Global = 0.0;
+        float Player = 1.0, NPC = 1.0;
+        float Teammate = 0.0;
+        float Essential = 1.0, Protected = 1.0;
+        float Unique = 0.0;
+        float Respawns[2] = {0.0, 1.0};
+
+        float Power = 3.0;
+        float Sneak = 0.5;
+        float Bash = 1.5;
+        float Block = 0.7;
+};
+
+// kept in the order of the original per-hit evaluation so the table holds
+// bit-identical results
+inline float Group::Evaluate(ActorTraits traits, std::uint8_t flags) const
+{
+    float ret = Global;
+    if (traits & kPlayer) ret *= Player;
+    else {
+        ret *= NPC;
+        if (traits & kTeammate) ret *= Teammate;
+        if (traits & kEssential) ret *= Essential;
+        else if (traits & kProtected) ret *= Protected;
+        if (traits & kUnique) ret *= Unique;
+        ret *= Respawns[!!(traits & kRespawns)];
+    }
+    if (flags & kHitPower  ) ret *= Power;
+    if (flags & kHitSneak  ) ret *= Sneak;
+    if (flags & kHitBash   ) ret *= Bash;
+    if (flags & kHitBlocked) ret *= Block;
+    return std::isfinite(ret) && ret > 0.0 ? ret : 0.0;
+}
+
+inline void Group::Compile()
+{
+    for (ActorTraits traits = 0; traits < 1 << kTraitBits; traits++)
+        for (std::uint8_t bits = 0; bits < 16; bits++)
+            _table[traits << 4 | bits] = Evaluate(traits, bits);
+    _enabled = std::any_of(_table.begin(), _table.end(), [](auto v) { return v > 0.0; });
+}
+
+inline void Group::Load(CSimpleIniA& ini, const char * section)
+{
+    if (auto v = ini.GetDoubleValue(section, "Global"     , -fInf); v >= 0.0) Global      = v;
+    if (auto v = ini.GetDoubleValue(section, "Player"     , -fInf); v >= 0.0) Player      = v;
+    if (auto v = ini.GetDoubleValue(section, "NPC"        , -fInf); v >= 0.0) NPC         = v;
+    if (auto v = ini.GetDoubleValue(section, "Teammate"   , -fInf); v >= 0.0) Teammate    = v;
+    if (auto v = ini.GetDoubleValue(section, "Essential"  , -fInf); v >= 0.0) Essential   = v;
+    if (auto v = ini.GetDoubleValue(section, "Protected"  , -fInf); v >= 0.0) Protected   = v;
+    if (auto v = ini.GetDoubleValue(section, "Unique"     , -fInf); v >= 0.0) Unique      = v;
+    if (auto v = ini.GetDoubleValue(section, "RespawnsNot", -fInf); v >= 0.0) Respawns[0] = v;
+    if (auto v = ini.GetDoubleValue(section, "Respawns"   , -fInf); v >= 0.0) Respawns[1] = v;
+    if (auto v = ini.GetDoubleValue(section, "Power"      , -fInf); v >= 0.0) Power       = v;
+    if (auto v = ini.GetDoubleValue(section, "Sneak"      , -fInf); v >= 0.0) Sneak       = v;
+    if (auto v = ini.GetDoubleValue(section, "Bash"       , -fInf); v >= 0.0) Bash        = v;
+    if (auto v = ini.GetDoubleValue(section, "Block"      , -fInf); v >= 0.0) Block       = v;
+    Compile();
+}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include "FlatMap.h"
+
+namespace DurabilityNG {
+
+using KeywordBits = std::uint64_t; // one bit per [Materials] keyword
+
+// [Materials] keywords mapped to dense bit indices. Positive values are
+// materials (geometric mean), negative ones plain factors and zero makes the
+// multiplier zero. A form's keywords fold into a KeywordBits mask once, and
+// the multiplier is summed in the log domain so only one exp is needed.
+class MaterialMults {
+    public:
+        // the first value of a keyword wins; false once all 64 bits are taken
+        bool Add(std::uint32_t keyword, float mult) {
+            if (_index.Find(keyword)) return true;
+            const auto i = static_cast<std::uint32_t>(_index.Size());
+            if (i >= _log.size()) return false;
+            _index[keyword] = i;
+            if (mult == 0.0)
+                _zero |= KeywordBits(1) << i;
+            else {
+                if (mult > 0.0) _material |= KeywordBits(1) << i;
+                _log[i] = std::log(std::abs(mult));
+            }
+            return true;
+        };
+        inline bool Empty() const { return !_index.Size(); };
+        inline void SetDefault(float mult) { _noMaterial = mult; };
+
+        inline KeywordBits Bit(std::uint32_t keyword) const {
+            const auto i = _index.Find(keyword);
+            return i ? KeywordBits(1) << *i : 0;
+        };
+
+        // geometric mean of the materials times the other factors
+        float operator()(KeywordBits bits) const {
+            if (bits & _zero) return 0.0;
+            const auto materials = std::popcount(bits & _material);
+            double mat = 0.0, oth = 0.0;
+            for (auto b = bits; b; b &= b - 1) {
+                const auto i = std::countr_zero(b);
+                (_material >> i & 1 ? mat : oth) += _log[i];
+            }
+            if (!materials) return _noMaterial * std::exp(oth);
+            return std::exp(mat / materials + oth);
+        };
+    private:
+        Tools::FlatMap<std::uint32_t, std::uint32_t> _index;
+        std::array<double, 64> _log{};
+        KeywordBits _material = 0;
+        KeywordBits _zero = 0;
+        float _noMaterial = 2.5;
+};
+
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <memory_resource>
+#include <vector>
+#include "Tools.h"
+
+namespace DurabilityNG {
+
+template <class T>
+class PickOne {
+	public:
+		inline bool Has() { return _weight > 0.0; };
+		inline T Get(T fallback) { return Has() ? _curr : fallback; };
+		inline void Push(T cand, float weight = 1.0) {
+			_weight += weight;
+			if (Tools::RandU<float>(_weight) < weight) _curr = cand;
+		};
+	private:
+		T _curr;
+		double _weight = 0;
+};
+
+// Same as PickOne, but Push only records the candidate with the running sum
+// of the weights and the winner is chosen with a single random draw.
+// Past N candidates the last slot turns into a PickOne-style reservoir.
+template <class T, std::size_t N = 32>
+class PickOnePrefix {
+	static_assert(N >= 2);
+	public:
+		inline bool Has() { return _total > 0.0f; };
+		inline T Get(T fallback) {
+			if (!Has()) return fallback;
+			if (!_drawn) Draw();
+			return _curr;
+		};
+		inline void Push(T cand, float weight = 1.0) {
+			_drawn = false;
+			_total += weight;
+			if (_size < N) {
+				_cands[_size] = cand;
+				_sums[_size++] = _total;
+			} else {
+				_sums[N - 1] = _total;
+				if (Tools::RandU<float>(_total - _sums[N - 2]) < weight) _cands[N - 1] = cand;
+			}
+		};
+	private:
+		void Draw() {
+			const float v = Tools::RandU<float>(_total);
+			// the sums ascend, so the winner's index is how many lie at or
+			// below v; counting them has no unpredictable branch
+			std::size_t i = 0;
+			for (std::size_t j = 0; j + 1 < _size; j++) i += !(v < _sums[j]);
+			_curr = _cands[i];
+			_drawn = true;
+		};
+		std::array<float, N> _sums;
+		std::array<T, N> _cands;
+		std::size_t _size = 0;
+		float _total = 0;
+		T _curr;
+		bool _drawn = false;
+};
+
+// PickList weight storage: scan all weights per pull, O(n).
+// Cheapest for the short lists of NPC inventories.
+struct LinearPick {
+	template <typename W>
+	class Sampler {
+		public:
+			explicit Sampler(std::pmr::memory_resource* mr) : _weights(mr) {};
+			inline void Reserve(std::size_t n) { _weights.reserve(n); };
+			inline void Push(W w) { _weights.push_back(w); };
+			inline W Get(std::size_t i) const { return _weights[i]; };
+			inline void Set(std::size_t i, W w) { _weights[i] = w; };
+			// index of the entry covering v in [0, sum), size() if none
+			inline std::size_t Find(double v) const {
+				std::size_t i = 0;
+				for (; i < _weights.size(); i++) {
+					if (v < _weights[i]) break;
+					v -= _weights[i];
+				}
+				return i;
+			};
+		private:
+			std::pmr::vector<W> _weights;
+	};
+};
+
+// PickList weight storage: Fenwick tree over the weights, O(log n) per pull
+// and update. The tree is built in O(n) on the first pull after a push.
+struct FenwickPick {
+	template <typename W>
+	class Sampler {
+		public:
+			explicit Sampler(std::pmr::memory_resource* mr) : _weights(mr), _tree(mr) {};
+			inline void Reserve(std::size_t n) { _weights.reserve(n); _tree.reserve(n + 1); };
+			inline void Push(W w) { _weights.push_back(w); _dirty = true; };
+			inline W Get(std::size_t i) const { return _weights[i]; };
+			inline void Set(std::size_t i, W w) {
+				if (!_dirty) {
+					const double d = static_cast<double>(w) - _weights[i];
+					for (auto j = i + 1; j < _tree.size(); j += j & (0 - j))
+						_tree[j] += d;
+				}
+				_weights[i] = w;
+			};
+			inline std::size_t Find(double v) {
+				if (_dirty) Build();
+				const auto n = _weights.size();
+				std::size_t pos = 0;
+				for (auto step = std::bit_floor(n); step; step >>= 1)
+					if (pos + step <= n && _tree[pos + step] <= v) {
+						pos += step;
+						v -= _tree[pos];
+					}
+				return pos;
+			};
+		private:
+			void Build() {
+				const auto n = _weights.size();
+				_tree.assign(n + 1, 0.0);
+				for (std::size_t i = 1; i <= n; i++) {
+					_tree[i] += _weights[i - 1];
+					if (auto j = i + (i & (0 - i)); j <= n)
+						_tree[j] += _tree[i];
+				}
+				_dirty = false;
+			};
+			std::pmr::vector<W> _weights;
+			std::pmr::vector<double> _tree;
+			bool _dirty = false;
+	};
+};
+
+// Weighted sampling without replacement. Storage comes from the given
+// memory resource, so a hit can keep it in its arena.
+template <class T, typename W = float, class Policy = LinearPick>
+class PickList {
+	public:
+		inline double weightSum() { return _weightSum; };
+		inline void Push(const T&& val, const W& w) {
+			if (w > 0.0) {
+				_entries.emplace_back(val);
+				_weights.Push(w);
+				_weightSum += w;
+			}
+		};
+
+		inline T* Pull(W* weight1 = nullptr) {
+			if (0.0 < _weightSum) {
+				auto i = _weights.Find(Tools::RandU(_weightSum));
+				if (i < _entries.size()) {
+					const W w = _weights.Get(i);
+					_weightSum -= w;
+					if (weight1) *weight1 = w;
+					_weights.Set(i, 0);
+					return &_entries[i];
+				}
+			}
+			return nullptr;
+		};
+
+		// change the weight of an entry returned by Pull or still in the list
+		inline void Update(const T* item, const W& w) {
+			const auto i = static_cast<std::size_t>(item - _entries.data());
+			_weightSum += w - _weights.Get(i);
+			_weights.Set(i, w);
+		};
+
+		PickList(unsigned int reserve = 0, std::pmr::memory_resource* mr = std::pmr::get_default_resource())
+			: _entries(mr), _weights(mr) {
+			_entries.reserve(reserve);
+			_weights.Reserve(reserve);
+		};
+
+	private:
+		std::pmr::vector<T> _entries;
+		typename Policy::template Sampler<W> _weights;
+		double _weightSum = 0;
+};
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace DurabilityNG {
+
+// pow(x, exponent) on [lo, hi], sampled on a uniform grid and linearly
+// interpolated; outside the range it falls back to pow. Linear interpolation
+// is off by at most h^2/8 * |f''|, i.e. a relative error of
+// h^2/8 * |e(e-1)| / x^2 for grid step h. For the default Break.ExponentLow
+// (-0.5) over [0.01, 1] that is below 0.1%; Build measures the maximum.
+class PowTable {
+    public:
+        void Build(float lo, float hi, float exponent) {
+            _lo = lo;
+            _hi = hi;
+            _exp = exponent;
+            _scale = kSize / (hi - lo);
+            for (std::size_t i = 0; i <= kSize; i++)
+                _values[i] = std::pow(lo + (hi - lo) * i / kSize, exponent);
+            // the error peaks between grid points, check a few per interval
+            _maxError = 0;
+            for (std::size_t i = 0; i < kSize; i++)
+                for (float f : {0.25f, 0.5f, 0.75f}) {
+                    const float x = lo + (hi - lo) * (i + f) / kSize;
+                    const double exact = std::pow(double(x), double(exponent));
+                    if (exact != 0.0 && std::isfinite(exact))
+                        _maxError = std::max(_maxError, float(std::abs((*this)(x) - exact) / exact));
+                }
+        };
+        inline float operator()(float x) const {
+            if (!(x >= _lo && x < _hi)) return std::pow(x, _exp);
+            const float t = (x - _lo) * _scale;
+            const auto i = std::min(static_cast<std::size_t>(t), kSize - 1);
+            const float f = t - i;
+            return _values[i] + (_values[i + 1] - _values[i]) * f;
+        };
+        inline float MaxError() const { return _maxError; };
+    private:
+        static constexpr std::size_t kSize = 1024;
+        std::array<float, kSize + 1> _values{};
+        float _lo = 0, _hi = 0, _scale = 0, _exp = 0;
+        float _maxError = 0;
+};
+
+}
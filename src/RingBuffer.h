@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Tools {
+
+    // Bounded lock-free queue, many producers / one consumer (Vyukov).
+    // Each cell carries a sequence number telling whose turn it is, so a push
+    // is one CAS on the head plus one release store and never blocks.
+    template <class T, std::size_t N>
+    class RingBuffer {
+        static_assert(N && !(N & (N - 1)), "capacity must be a power of two");
+        public:
+            RingBuffer() {
+                for (std::size_t i = 0; i < N; i++)
+                    _cells[i].seq.store(i, std::memory_order_relaxed);
+            };
+
+            inline bool TryPush(const T& val) {
+                auto pos = _head.load(std::memory_order_relaxed);
+                for (;;) {
+                    auto& cell = _cells[pos & (N - 1)];
+                    const auto seq = cell.seq.load(std::memory_order_acquire);
+                    const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                    if (diff == 0) {
+                        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                            cell.val = val;
+                            cell.seq.store(pos + 1, std::memory_order_release);
+                            return true;
+                        }
+                    } else if (diff < 0)
+                        return false; // full
+                    else
+                        pos = _head.load(std::memory_order_relaxed);
+                }
+            };
+
+            // consumer side only
+            inline bool TryPop(T& val) {
+                auto& cell = _cells[_tail & (N - 1)];
+                if (cell.seq.load(std::memory_order_acquire) != _tail + 1) return false;
+                val = cell.val;
+                cell.seq.store(_tail + N, std::memory_order_release);
+                _tail++;
+                return true;
+            };
+
+            // consumer side only
+            inline std::size_t Size() const {
+                return _head.load(std::memory_order_relaxed) - _tail;
+            };
+
+            static constexpr std::size_t Capacity() { return N; };
+
+        private:
+            struct Cell {
+                std::atomic<std::size_t> seq;
+                T val{};
+            };
+            alignas(64) std::atomic<std::size_t> _head{0};
+            alignas(64) std::size_t _tail = 0;
+            alignas(64) std::array<Cell, N> _cells;
+    };
+
+}
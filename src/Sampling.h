@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "Tools.h"
+
+namespace DurabilityNG {
+
+// Turns an expected number of events into a random count with that mean:
+// floor(expected) certain events plus one more with the remainder as chance.
+// A hit that stands for several (subsampled or throttled) carries the sum of
+// their chances, which can exceed 1; rolling once would cap it there.
+inline std::uint32_t Rolls(float expected) {
+    if (!(expected > 0.0f)) return 0;
+    const float whole = std::floor(expected);
+    return static_cast<std::uint32_t>(whole) + (expected - whole > Tools::RandU<float>());
+}
+
+// Destroy rolls for a hit with chance info that stands for `hits` hits. Each
+// represented hit rolls at most once, as a single hit always did (info >= 1
+// is a certain roll), so only subsampling and throttling raise the count.
+inline std::uint32_t DestroyRolls(float info, float hits) {
+    return Rolls(std::min(info, 1.0f) * hits);
+}
+
+// How many hits a hit kept by [Subsample] with fraction p stands for: 1/p
+// with chance p, else 0 to skip it, so the expected count stays 1.
+inline float SubsampleWeight(float p) {
+    if (p >= 1.0f) return 1.0f;
+    return Tools::RandU<float>() < p ? 1.0f / p : 0.0f;
+}
+
+// Chance to survive `hits` equal degrades taking health from `from` down to
+// `to`, where survival(x) is the chance to survive one that leaves health x.
+// The hits are split into up to kPathPoints groups, each evaluated at the
+// health its middle hit leaves; pow(survival(to), hits) would charge every
+// hit at the lowest health. Exact while hits <= kPathPoints.
+inline constexpr int kPathPoints = 16;
+
+template <class F>
+float PathSurvival(float from, float to, float hits, F&& survival) {
+    const int points = std::clamp(static_cast<int>(std::ceil(hits)), 1, kPathPoints);
+    const float share = hits / points;
+    const float step = (to - from) / hits;
+    float p = 1.0f;
+    for (int i = 0; i < points; i++) {
+        const float s = survival(from + step * std::min(hits, i * share + (share + 1.0f) / 2));
+        if (s < 1.0f) p *= share == 1.0f ? s : std::pow(s, share);
+    }
+    return p;
+}
+
+}
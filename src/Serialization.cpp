@@ -0,0 +1,143 @@
+#include "Serialization.h"
+#include "Cache.h"
+#include "Codec.h"
+#include "Events.h"
+
+#include <algorithm>
+#include <chrono>
+#include <tuple>
+
+namespace DurabilityNG {
+
+namespace {
+
+constexpr std::uint32_t kUniqueID = 'DUNG';
+constexpr std::uint32_t kWearRecord = 'WEAR';
+constexpr std::uint32_t kShadowRecord = 'SHDW';
+constexpr std::uint32_t kVersion = 1;
+
+bool WriteRecord(SKSE::SerializationInterface* intfc, std::uint32_t type, const Writer& out) {
+    return intfc->OpenRecord(type, kVersion)
+        && intfc->WriteRecordData(out.Data().data(), static_cast<std::uint32_t>(out.Size()));
+}
+
+// actor, form, then per item: u8 left | flags << 1, f32 wear, f32 hits
+void SaveWear(Writer& out) {
+    std::vector<std::tuple<RE::FormID, RE::FormID, const CombatWear::Wear*>> rows;
+    CombatWear::GetSingleton()->ForEach([&](RE::FormID actor, const CombatWear::Wear& w) {
+        if (w.form) rows.emplace_back(actor, w.form->GetFormID(), &w);
+    });
+    std::ranges::sort(rows, {}, [](const auto& r) { return std::pair(std::get<0>(r), std::get<1>(r)); });
+    out.Varint(rows.size());
+    PairDelta ids;
+    for (const auto& [a, f, w] : rows) {
+        ids.Write(out, a, f);
+        out.U8(static_cast<std::uint8_t>(w->left | w->flags << 1));
+        out.F32(w->wear);
+        out.F32(w->hits);
+    }
+}
+
+void LoadWear(SKSE::SerializationInterface* intfc, Reader& in) {
+    auto* wear = CombatWear::GetSingleton();
+    PairDelta ids;
+    for (auto n = in.Varint(); n && in.ok; n--) {
+        const auto [actor, form] = ids.Read(in);
+        const auto bits = in.U8();
+        const auto w = in.F32();
+        const auto hits = in.F32();
+        RE::FormID newActor, newForm;
+        if (!in.ok || !intfc->ResolveFormID(actor, newActor) || !intfc->ResolveFormID(form, newForm)) continue;
+        if (auto obj = RE::TESForm::LookupByID<RE::TESBoundObject>(newForm); obj && hits > 0.0)
+            wear->Restore(newActor, {obj, static_cast<bool>(bits & 1), static_cast<std::uint8_t>(bits >> 1), w, hits});
+    }
+}
+
+// actor, form, then per shadow: u8 left, u16 health, u16 written
+void SaveShadows(Writer& out) {
+    std::vector<std::tuple<RE::FormID, RE::FormID, bool, float, float>> rows;
+    ShadowHealth::GetSingleton()->ForEach([&](RE::FormID actor, RE::FormID form, bool left, const ShadowHealth::Shadow& s) {
+        if (s.health != s.written) rows.emplace_back(actor, form, left, s.health, s.written);
+    });
+    std::ranges::sort(rows);
+    out.Varint(rows.size());
+    PairDelta ids;
+    for (const auto& [a, f, left, health, written] : rows) {
+        ids.Write(out, a, f);
+        out.U8(left);
+        out.Health(health);
+        out.Health(written);
+    }
+}
+
+void LoadShadows(SKSE::SerializationInterface* intfc, Reader& in) {
+    auto* shadows = ShadowHealth::GetSingleton();
+    PairDelta ids;
+    for (auto n = in.Varint(); n && in.ok; n--) {
+        const auto [actor, form] = ids.Read(in);
+        const bool left = in.U8();
+        const auto health = in.Health();
+        const auto written = in.Health();
+        RE::FormID newActor, newForm;
+        if (!in.ok || !intfc->ResolveFormID(actor, newActor) || !intfc->ResolveFormID(form, newForm)) continue;
+        shadows->Restore(newActor, newForm, left, health, written);
+    }
+}
+
+void OnSave(SKSE::SerializationInterface* intfc) {
+    const auto start = std::chrono::steady_clock::now();
+    Writer wear, shadows;
+    SaveWear(wear);
+    SaveShadows(shadows);
+    if (!WriteRecord(intfc, kWearRecord, wear) || !WriteRecord(intfc, kShadowRecord, shadows))
+        SKSE::log::error("failed to write co-save records");
+    SKSE::log::info("co-save: {} + {} bytes in {} us", wear.Size(), shadows.Size(),
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void OnLoad(SKSE::SerializationInterface* intfc) {
+    std::uint32_t type, version, length;
+    while (intfc->GetNextRecordInfo(type, version, length)) {
+        if (version != kVersion) {
+            SKSE::log::warn("skipping co-save record {:08X} version {}", type, version);
+            continue;
+        }
+        std::vector<std::uint8_t> buf(length);
+        const bool read = intfc->ReadRecordData(buf.data(), length) == length;
+        Reader in(std::move(buf));
+        in.ok = read;
+        switch (type) {
+        case kWearRecord:
+            LoadWear(intfc, in);
+            break;
+        case kShadowRecord:
+            LoadShadows(intfc, in);
+            break;
+        default:
+            SKSE::log::warn("unknown co-save record {:08X}", type);
+            continue;
+        }
+        if (!in.ok) SKSE::log::warn("truncated co-save record {:08X}", type);
+    }
+}
+
+// also runs before a new game, where persistent actors like the player
+// keep their FormID but none of the cached pointers stay valid
+void OnRevert(SKSE::SerializationInterface*) {
+    ActorCache::GetSingleton()->Clear();
+    CombatWear::GetSingleton()->Clear();
+    ShadowHealth::GetSingleton()->Clear();
+    RevertEvents();
+}
+
+}
+
+void InitSerialization() {
+    auto* intfc = SKSE::GetSerializationInterface();
+    intfc->SetUniqueID(kUniqueID);
+    intfc->SetSaveCallback(OnSave);
+    intfc->SetLoadCallback(OnLoad);
+    intfc->SetRevertCallback(OnRevert);
+}
+
+}
@@ -1,17 +1,12 @@
 #include "Settings.h"
+#include "Cache.h"
+#include "Arena.h"
+#include "Sampling.h"
 
-namespace DurabilityNG {
-
+#include <algorithm>
+#include <chrono>
 
-inline RE::ExtraDataList* GetWorn(RE::BSSimpleList<RE::ExtraDataList*>* extraLists, bool left = false) {
-    if (extraLists) {
-        auto edt = left ? RE::ExtraDataType::kWornLeft : RE::ExtraDataType::kWorn;
-        for (auto& edl : *extraLists)
-            if (edl->HasType(edt))
-                return edl;
-    }
-    return nullptr;
-};
+namespace DurabilityNG {
 
 void Settings::Degrade(
     const GroupActorInfo &info,
@@ -19,7 +14,8 @@ void Settings::Degrade(
     RE::InventoryEntryData *entry,
     const HitFlags &flags,
     bool left,
-    float mult
+    float mult,
+    float hits
 ) {
     if (!subject) return;
     if (!entry) return;
@@ -27,57 +23,100 @@ void Settings::Degrade(
     auto *form = entry->object;
     if (!form) return;
     if (!form->GetPlayable()) return;
-    auto *worn = GetWorn(entry->extraLists, left);
-    if (!worn) return;
+    auto *slot = ActorCache::GetSingleton()->FindWorn(subject, entry, left);
+    if (!slot) return;
+    auto *worn = slot->list;
 
-    mult *= info;
-    mult *= GetMult(entry->object->As<RE::BGSKeywordForm>());
+    mult *= info * hits;
+    mult *= GetMult(form);
     if (!(mult > 0.0)) return;
     
-    auto *edHealth = worn->GetByType<RE::ExtraHealth>();
-    const float old = edHealth ? edHealth->health : 1.0;
+    // a slot cached without health is re-read: tempering or another plugin
+    // may have added one since, and a second ExtraHealth must not be added.
+    // Only items still at full health take this path.
+    auto *edHealth = slot->health ? slot->health : (slot->health = worn->GetByType<RE::ExtraHealth>());
+    auto *shadows = ShadowHealth::GetSingleton();
+    auto *shadow = writeBackStep > 0.0 && edHealth ? &shadows->Get(subject, form, left, edHealth) : nullptr;
+    const float old = shadow ? shadow->health : edHealth ? edHealth->health : 1.0;
     const float cur = std::max(minHealth, old - mult);
     
     do {
-        float exp = breakExponent[cur >= 1.0];
-        if (!std::isfinite(exp)) break;
-        float destroy = Break.ActorInfo(subject, flags);
-        if (!(destroy > 1.0)) break;
+        if (!std::isfinite(breakExponent[cur >= 1.0])) break;
+        const float base = Break.ActorInfo(subject, flags.underlying());
+        if (!(base > 1.0)) break;
         if (entry->IsQuestObject()) break;
-        if (exp) destroy *= pow(cur, exp);
+        // the item has to survive every hit this call stands for, each at
+        // the health it left
+        const auto survival = [&](float x) {
+            x = std::max(minHealth, x);
+            const float e = breakExponent[x >= 1.0];
+            if (!std::isfinite(e)) return 1.0f;
+            return e ? base * breakCurve[x >= 1.0](x) : base;
+        };
+        const float destroy = hits == 1.0 ? survival(cur) : PathSurvival(old, old - mult, hits, survival);
         if (destroy > Tools::RandU<float>()) break;
 
         if (breakMessage && subject->IsPlayer()) {
-            std::string msg = "Destroyed worn ";
+            Tools::Arena arena;
+            std::pmr::string msg{"Destroyed worn ", arena.get()};
             msg += worn->GetDisplayName(form);
             RE::DebugNotification(msg.c_str());
         }
 
+        if (shadow) shadows->Erase(subject, form, left);
         subject->RemoveItem(form, 1, RE::ITEM_REMOVE_REASON::kRemove, worn, NULL);
         return;
     } while(false);
     
     if (cur < old) {
+        if (shadow) {
+            shadow->health = cur;
+            if (!shadows->Due(*shadow)) {
+                Count(Stats::GetSingleton()->shadowAbsorbed);
+                return;
+            }
+            shadow->written = cur;
+        }
         if (edHealth) edHealth->health = cur;
-        else worn->Add(new RE::ExtraHealth(cur));
+        else worn->Add(slot->health = new RE::ExtraHealth(cur));
 
-        subject->AddChange(0x8000420); // 5 10 27
-        subject->OnArmorActorValueChanged();
+        ArmorUpdates::GetSingleton()->Mark(subject);
     }
 }
 
+void Settings::Degrade(
+    const GroupActorInfo &info,
+    RE::Actor *subject,
+    RE::TESBoundObject *form,
+    const HitFlags &flags,
+    bool left,
+    float mult,
+    float hits
+) {
+    if (!subject) return;
+    if (!form) return;
+    if (!info) return;
+    Degrade(info, subject, ActorCache::GetSingleton()->FindEntry(subject, form), flags, left, mult, hits);
+}
+
 float Settings::DestroyWeight(RE::TESBoundObject *form)
 {
-    auto res = form->GetWeight();
-    if (destroyMaterialExponent > 0.0)
-        res *= pow(GetMult(form->As<RE::BGSKeywordForm>()), destroyMaterialExponent);
-    return res;
+    return GetAttributes(form).destroyWeight;
+}
+
+float Settings::SubsampleFraction(float distance) const
+{
+    float p = 1.0;
+    for (const auto& [min, frac] : subsampleBands) {
+        if (distance < min) break;
+        p = frac;
+    }
+    return p;
 }
 
-float Settings::DestroyResist(RE::Actor *subject)
+float Settings::DestroyResist(float dr) const
 {
     float res = destroyResistBase;
-    float dr = subject->AsActorValueOwner()->GetActorValue(RE::ActorValue::kDamageResist);
     if (dr > 0.0 && destroyResistPivot > 0.0 && destroyResistExponent > 0.0)
         res += destroyResistPivot * pow(dr / destroyResistPivot, destroyResistExponent);
     return res > 1.0 ? res : 1.0;
@@ -89,69 +128,110 @@ Settings *Settings::GetSingleton()
 	return std::addressof(singleton);
 }
 
+float Settings::GetMult(const RE::TESForm *form)
+{
+    return GetAttributes(form).mult;
+}
+
+const Settings::FormAttributes& Settings::GetAttributes(const RE::TESForm *form)
+{
+    const auto id = form->GetFormID();
+    if (auto i = formIndex.Find(id)) {
+        auto& row = formTable[*i];
+        if (row.form != form) row = MakeAttributes(form);
+        return row;
+    }
+    // forms created after data load
+    formIndex[id] = static_cast<std::uint32_t>(formTable.size());
+    return formTable.emplace_back(MakeAttributes(form));
+}
+
+Settings::FormAttributes Settings::MakeAttributes(const RE::TESForm *form)
+{
+    const float mult = GetMult(form->As<RE::BGSKeywordForm>());
+    float weight = form->GetWeight();
+    if (destroyMaterialExponent > 0.0)
+        weight *= pow(mult, destroyMaterialExponent);
+    return {form, mult, weight};
+}
+
+// run after every settings load, the values depend on [Materials] and
+// Destroy.MaterialExponent
+void Settings::BuildFormTable()
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto* dh = RE::TESDataHandler::GetSingleton();
+    formIndex.Clear();
+    formTable.clear();
+    auto add = [&](const auto& forms) {
+        formIndex.Reserve(formTable.size() + forms.size());
+        formTable.reserve(formTable.size() + forms.size());
+        for (const auto* form : forms)
+            if (form) {
+                formIndex[form->GetFormID()] = static_cast<std::uint32_t>(formTable.size());
+                formTable.emplace_back(MakeAttributes(form));
+            }
+    };
+    add(dh->GetFormArray<RE::TESObjectARMO>());
+    add(dh->GetFormArray<RE::TESObjectWEAP>());
+    add(dh->GetFormArray<RE::TESObjectMISC>());
+    add(dh->GetFormArray<RE::TESAmmo>());
+    add(dh->GetFormArray<RE::AlchemyItem>());
+    add(dh->GetFormArray<RE::IngredientItem>());
+    add(dh->GetFormArray<RE::TESObjectBOOK>());
+    add(dh->GetFormArray<RE::TESSoulGem>());
+    const std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - start;
+    SKSE::log::info("form table: {} forms in {:.2f} ms", formTable.size(), took.count());
+}
+
 float Settings::GetMult(const RE::BGSKeywordForm *form)
 {
     if (!form) return 1.0;
-    float oth = 1.0;
-    float mat = 1.0;
-    int materials = 0;
-    for (const auto& kw : form->GetKeywords()) {
-        const auto val = kw2mul.find(kw->GetFormID());
-        if (val != kw2mul.cend()) {
-            if (val->second == 0.0) return 0.0;
-            if (val->second > 0.0) {
-                materials++;
-                mat *= val->second;
-            } else
-                oth *= -val->second;
+    return materials(GetKeywordBits(form));
+}
+
+KeywordBits Settings::GetKeywordBits(const RE::BGSKeywordForm *form) const
+{
+    KeywordBits bits = 0;
+    if (!materials.Empty())
+        for (const auto& kw : form->GetKeywords())
+            if (kw) bits |= materials.Bit(kw->GetFormID());
+    return bits;
+}
+
+// health normally stays within minHealth..~2, tempered gear can go higher;
+// also run by the constructor so the defaults work without an INI
+void Settings::BuildBreakCurves()
+{
+    for (int i = 0; i < 2; i++)
+        if (std::isfinite(breakExponent[i]) && breakExponent[i]) {
+            if (i) breakCurve[i].Build(1.0, 4.0, breakExponent[i]);
+            else   breakCurve[i].Build(minHealth, 1.0, breakExponent[i]);
         }
-    }
-    switch (materials) {
-        case 0: mat = noMaterialMult; break;
-        case 1: break;
-        case 2: mat = std::sqrt(mat); break;
-        case 3: mat = std::cbrt(mat); break;
-        default: mat = std::pow(mat, 1.0/materials); break;
-    }
-    return mat * oth;
 }
 
-GroupActorInfo Group::ActorInfo(const RE::Actor *target, const HitFlags& flags)
+ActorTraits GetActorTraits(const RE::Actor *target)
 {
-    if (!target) return 0.0;
-    float ret = Global;
-    if (target->IsPlayer()) ret *= Player;
-    else {
-        ret *= NPC;
-        if (target->IsPlayerTeammate()) ret *= Teammate;
-        if (target->IsEssential()) ret *= Essential;
-        else if (target->IsProtected()) ret *= Protected;
-        const auto& base = target->GetActorBase();
-        if (base && base->IsUnique()) ret *= Unique;
-        ret *= Respawns[base && base->Respawns()];
-    }
-    if (flags.any(RE::TESHitEvent::Flag::kPowerAttack)) ret *= Power;
-    if (flags.any(RE::TESHitEvent::Flag::kSneakAttack)) ret *= Sneak;
-    if (flags.any(RE::TESHitEvent::Flag::kBashAttack )) ret *= Bash;
-    if (flags.any(RE::TESHitEvent::Flag::kHitBlocked )) ret *= Block;
-    return std::isfinite(ret) && ret > 0.0 ? ret : 0.0;
+    if (target->IsPlayer()) return kPlayer;
+    ActorTraits traits = 0;
+    if (target->IsPlayerTeammate()) traits |= kTeammate;
+    if (target->IsEssential()) traits |= kEssential;
+    else if (target->IsProtected()) traits |= kProtected;
+    const auto& base = target->GetActorBase();
+    if (base && base->IsUnique()) traits |= kUnique;
+    if (base && base->Respawns()) traits |= kRespawns;
+    return traits;
 }
 
-void Group::Load(CSimpleIniA& ini, const char * section)
+static_assert(kHitPower   == std::to_underlying(RE::TESHitEvent::Flag::kPowerAttack));
+static_assert(kHitSneak   == std::to_underlying(RE::TESHitEvent::Flag::kSneakAttack));
+static_assert(kHitBash    == std::to_underlying(RE::TESHitEvent::Flag::kBashAttack));
+static_assert(kHitBlocked == std::to_underlying(RE::TESHitEvent::Flag::kHitBlocked));
+
+GroupActorInfo Group::ActorInfo(const RE::Actor *target, std::uint8_t flags)
 {
-    if (auto v = ini.GetDoubleValue(section, "Global"     , -fInf); v >= 0.0) Global      = v;
-    if (auto v = ini.GetDoubleValue(section, "Player"     , -fInf); v >= 0.0) Player      = v;
-    if (auto v = ini.GetDoubleValue(section, "NPC"        , -fInf); v >= 0.0) NPC         = v;
-    if (auto v = ini.GetDoubleValue(section, "Teammate"   , -fInf); v >= 0.0) Teammate    = v;
-    if (auto v = ini.GetDoubleValue(section, "Essential"  , -fInf); v >= 0.0) Essential   = v;
-    if (auto v = ini.GetDoubleValue(section, "Protected"  , -fInf); v >= 0.0) Protected   = v;
-    if (auto v = ini.GetDoubleValue(section, "Unique"     , -fInf); v >= 0.0) Unique      = v;
-    if (auto v = ini.GetDoubleValue(section, "RespawnsNot", -fInf); v >= 0.0) Respawns[0] = v;
-    if (auto v = ini.GetDoubleValue(section, "Respawns"   , -fInf); v >= 0.0) Respawns[1] = v;
-    if (auto v = ini.GetDoubleValue(section, "Power"      , -fInf); v >= 0.0) Power       = v;
-    if (auto v = ini.GetDoubleValue(section, "Sneak"      , -fInf); v >= 0.0) Sneak       = v;
-    if (auto v = ini.GetDoubleValue(section, "Bash"       , -fInf); v >= 0.0) Bash        = v;
-    if (auto v = ini.GetDoubleValue(section, "Block"      , -fInf); v >= 0.0) Block       = v;
+    if (!target) return 0.0;
+    return ActorInfo(GetActorTraits(target), flags);
 }
 
 void Settings::Load(CSimpleIniA &ini)
@@ -175,20 +255,55 @@ void Settings::Load(CSimpleIniA &ini)
     
     if (auto v = ini.GetLongValue("Destroy", "Message", -1); v >= 0) destroyMessage = v;
 
+    BuildBreakCurves();
+    for (int i = 0; i < 2; i++)
+        if (std::isfinite(breakExponent[i]) && breakExponent[i])
+            SKSE::log::info("break curve {}: max relative error {:.2e}", i, breakCurve[i].MaxError());
+
+    deferHits = ini.GetBoolValue("Performance", "Deferred", deferHits);
+    if (auto v = ini.GetLongValue("Performance", "ResistRefreshMs", -1); v >= 0) resistRefreshMs = v;
+    if (auto v = ini.GetLongValue("Performance", "FrameBudgetUs"  , -1); v >= 0) frameBudgetUs   = v;
+    if (auto v = ini.GetLongValue("Performance", "MaxBacklog"     , -1); v >= 0) maxBacklog      = v;
+    aggregateNPC = ini.GetBoolValue("Performance", "AggregateNPC", aggregateNPC);
+    if (auto v = ini.GetDoubleValue("Performance", "WriteBackStep", -fInf); std::isfinite(v) && v >= 0.0) writeBackStep = v;
+    if (auto v = ini.GetLongValue("Performance", "MultiHitWindowMs", -1); v >= 0) multiHitWindowMs = v;
+    if (auto v = ini.GetDoubleValue("Performance", "MultiHitFactor", -fInf); std::isfinite(v) && v >= 0.0) multiHitFactor = v;
+    if (auto v = ini.GetDoubleValue("Performance", "HitRate"       , -fInf); std::isfinite(v) && v >= 0.0) hitRate        = v;
+    if (auto v = ini.GetDoubleValue("Performance", "HitBurst"      , -fInf); std::isfinite(v) && v >= 1.0) hitBurst       = v;
+
+    CSimpleIniA::TNamesDepend bands;
+    ini.GetAllKeys("Subsample", bands);
+    subsampleBands.clear();
+    for (auto& band : bands) {
+        // the key is the distance; strtod alone would read "far" as 0
+        char* end;
+        const auto dist = strtod(band.pItem, &end);
+        const bool number = end != band.pItem && !*end;
+        const auto frac = ini.GetDoubleValue("Subsample", band.pItem, -1.0);
+        if (number && dist >= 0.0 && frac > 0.0 && frac <= 1.0)
+            subsampleBands.emplace_back(static_cast<float>(dist), static_cast<float>(frac));
+        else
+            SKSE::log::warn("invalid subsample band: {}", band.pItem);
+    }
+    std::ranges::sort(subsampleBands);
+
     CSimpleIniA::TNamesDepend list;
     ini.GetAllKeys("Materials", list);
     for (auto& mat : list)
         if (auto v = ini.GetDoubleValue("Materials", mat.pItem, -1.0); v >= 0.0)
             if (strcmp(mat.pItem, "__default__"))
-                if (auto kw = RE::TESForm::LookupByEditorID<RE::BGSKeyword>(mat.pItem))
-                    kw2mul.try_emplace(kw->GetFormID(), v);
-                else
+                if (auto kw = RE::TESForm::LookupByEditorID<RE::BGSKeyword>(mat.pItem)) {
+                    if (!materials.Add(kw->GetFormID(), v))
+                        SKSE::log::warn("too many material keywords, ignoring {}", mat.pItem);
+                } else
                     SKSE::log::warn("unknown keyword: {}", mat.pItem);
             else
-                noMaterialMult = v;
+                materials.SetDefault(v);
         else
             SKSE::log::warn("invalid value for keyword: {}", mat.pItem);
 
+    BuildFormTable();
+
     SKSE::log::info("settings loaded");
 }
 
@@ -1,33 +1,15 @@
 #pragma once
 
-#include <limits>
+#include <array>
 #include "Tools.h"
-#include "SimpleIni.h"
+#include "FlatMap.h"
+#include "Group.h"
+#include "Materials.h"
+#include "PowTable.h"
 
 namespace DurabilityNG {
 
-using GroupActorInfo = float;
 using HitFlags = REX::EnumSet<RE::TESHitEvent::Flag, std::uint8_t>;
-constexpr float fNaN = std::numeric_limits<float>::quiet_NaN();
-constexpr float fInf = std::numeric_limits<float>::infinity();
-    
-class Group {
-    public:
-        GroupActorInfo ActorInfo(const RE::Actor* target, const HitFlags& flags);
-        void Load(CSimpleIniA& ini, const char * section);
-    private:
-        float Global = 0.0;
-        float Player = 1.0, NPC = 1.0;
-        float Teammate = 0.0;
-        float Essential = 1.0, Protected = 1.0;
-        float Unique = 0.0;
-        float Respawns[2] = {0.0, 1.0};
-
-        float Power = 3.0;
-        float Sneak = 0.5;
-        float Bash = 1.5;
-        float Block = 0.7;
-};
 
 class Settings {
 
@@ -39,6 +21,7 @@ class Settings {
         
         bool ignoreZeroArmor = true;
         float breakExponent[2] = {-0.5, fNaN};
+        PowTable breakCurve[2]; // pow(cur, breakExponent[cur >= 1.0])
         bool breakMessage = true;
         
         // Destroy
@@ -48,6 +31,23 @@ class Settings {
         float destroyResistExponent = 0.5;
         float destroyMaterialExponent = 0.5;
         uint32_t destroyMessage = 100;
+
+        // Performance
+        bool deferHits = false; // queue hits and process them once per frame
+        uint32_t resistRefreshMs = 1000; // max age of a damage resist snapshot
+        uint32_t frameBudgetUs = 0; // per-frame budget for non-player hits in deferred mode, 0 = unlimited
+        uint32_t maxBacklog = 256; // carried-over hits beyond this are processed over budget, 0 = no limit
+        bool aggregateNPC = false; // sum NPC-vs-NPC wear until combat ends (CombatWear)
+        float writeBackStep = 0.0; // health change written to ExtraHealth at once, 0 = every degrade (ShadowHealth)
+        uint32_t multiHitWindowMs = 0; // hits of one attacker and source within this window are one swing, 0 = off
+        float multiHitFactor = 1.0; // weapon wear of each extra hit of a swing, relative to the first
+        float hitRate = 0.0; // defense and destroy hits per second and defender, 0 = unlimited (HitLimiter)
+        float hitBurst = 10.0;
+
+        // [Subsample] distance from the player -> fraction of NPC-vs-NPC
+        // hits processed beyond it, ascending by distance
+        std::vector<std::pair<float, float>> subsampleBands;
+        float SubsampleFraction(float distance) const;
         
         void Load(CSimpleIniA& ini);
         
@@ -57,19 +57,46 @@ class Settings {
             RE::InventoryEntryData *entry,
             const HitFlags& flags,
             bool left,
-            float mult = 1.0
+            float mult = 1.0,
+            float hits = 1.0
+        );
+        void Degrade(
+            const GroupActorInfo& info,
+            RE::Actor *subject,
+            RE::TESBoundObject *form,
+            const HitFlags& flags,
+            bool left,
+            float mult = 1.0,
+            float hits = 1.0
         );
 
         float DestroyWeight(RE::TESBoundObject* form);
-        float DestroyResist(RE::Actor *subject);
+        float DestroyResist(float damageResist) const;
 
         static Settings* GetSingleton();
     private:
-        
+        Settings() { BuildBreakCurves(); };
 
+        void BuildBreakCurves();
         float GetMult(const RE::BGSKeywordForm *form);
-        std::unordered_map<RE::FormID, float> kw2mul;
-        float noMaterialMult = 2.5;
+        float GetMult(const RE::TESForm *form);
+        KeywordBits GetKeywordBits(const RE::BGSKeywordForm *form) const;
+
+        // per-form values derived from the settings
+        struct FormAttributes {
+            const RE::TESForm* form;
+            float mult;
+            float destroyWeight;
+        };
+        const FormAttributes& GetAttributes(const RE::TESForm *form);
+        FormAttributes MakeAttributes(const RE::TESForm *form);
+        void BuildFormTable();
+        MaterialMults materials;
+
+        // FormID -> compact index into formTable; the form pointer stored in
+        // the row guards against reused runtime FormIDs
+        Tools::FlatMap<RE::FormID, std::uint32_t> formIndex;
+        std::vector<FormAttributes> formTable;
         
 };
 
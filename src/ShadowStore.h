@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include "Codec.h"
+#include "FlatMap.h"
+#include "Stats.h"
+
+namespace DurabilityNG {
+
+// Shadows of item health per actor, form and hand, ahead of the engine's
+// Extra (anything holding a float health). Knows nothing about the game, so
+// the coherence rules can be tested on their own; ShadowHealth binds it to
+// RE::ExtraHealth.
+template <class Extra>
+class ShadowStore {
+    public:
+        struct Shadow {
+            Extra* extra;  // identifies the item instance, only used once found in a live list
+            float health;
+            float written; // what extra held when last seen
+        };
+        static constexpr float kQuantum = kHealthQuantum;
+
+        // the shadow of the instance holding extra, reset if the engine changed it
+        Shadow& Get(std::uint32_t actor, std::uint32_t form, bool left, Extra* extra) {
+            auto& shadow = _shadows[left][Key(actor, form)];
+            if (!shadow.extra && shadow.health > 0.0f && std::abs(shadow.written - extra->health) <= kQuantum) {
+                shadow.extra = extra; // restored from the co-save
+                shadow.written = extra->health;
+            } else if (shadow.extra != extra || shadow.written != extra->health) {
+                if (shadow.extra) Count(Stats::GetSingleton()->shadowResyncs);
+                shadow = {extra, extra->health, extra->health};
+            }
+            return shadow;
+        };
+        // whether the health moved far enough from what extra holds to show
+        bool Due(const Shadow& shadow, float step, float minHealth) const {
+            return std::abs(shadow.written - shadow.health) >= step
+                || shadow.health <= minHealth
+                || (shadow.written >= 1.0f) != (shadow.health >= 1.0f);
+        };
+        Shadow* Find(std::uint32_t actor, std::uint32_t form, bool left) {
+            return _shadows[left].Find(Key(actor, form));
+        };
+        void Erase(std::uint32_t actor, std::uint32_t form, bool left) {
+            _shadows[left].Erase(Key(actor, form));
+        };
+
+        // whether extra holds the instance the shadow belongs to; a shadow
+        // restored from the co-save claims one holding written, as Get does
+        bool Owns(const Shadow& shadow, const Extra* extra) const {
+            if (!extra) return false;
+            if (shadow.extra) return extra == shadow.extra;
+            return shadow.health > 0.0f && std::abs(shadow.written - extra->health) <= kQuantum;
+        };
+        // writes the shadow through, unless the engine changed extra since
+        bool Write(const Shadow& shadow, Extra* extra) const {
+            if (std::abs(extra->health - shadow.written) > (shadow.extra ? 0.0f : kQuantum)) return false;
+            Count(Stats::GetSingleton()->shadowWrites);
+            extra->health = shadow.health;
+            return true;
+        };
+
+        template <class F>
+        void ForEach(F&& func) {
+            for (const bool left : {false, true})
+                _shadows[left].ForEach([&](std::uint64_t key, const Shadow& shadow) {
+                    func(static_cast<std::uint32_t>(key >> 32), static_cast<std::uint32_t>(key), left, shadow);
+                });
+        };
+        // not bound to an Extra yet, Get adopts the first one holding written
+        void Restore(std::uint32_t actor, std::uint32_t form, bool left, float health, float written) {
+            _shadows[left][Key(actor, form)] = {nullptr, health, written};
+        };
+        void Clear() {
+            for (auto& shadows : _shadows) shadows.Clear();
+        };
+
+    protected:
+        static std::uint64_t Key(std::uint32_t actor, std::uint32_t form) {
+            return static_cast<std::uint64_t>(actor) << 32 | form;
+        };
+        Tools::FlatMap<std::uint64_t, Shadow> _shadows[2]; // right, left hand
+};
+
+}
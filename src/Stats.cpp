@@ -0,0 +1,27 @@
+#include "Stats.h"
+
+namespace DurabilityNG {
+
+void Stats::Log() const
+{
+    auto get = [](const Counter& c) { return c.load(std::memory_order_relaxed); };
+    SKSE::log::info("hit queue: {} queued, {} overflowed, {} drains", get(hitsQueued), get(hitsOverflow), get(drains));
+    SKSE::log::info("scheduler: {} player hits, {} deferred hit-frames, max backlog {}, {} over budget, {} subsampled away, {} multi-hits merged, {} throttled", get(priorityHits), get(deferredHits), get(maxBacklog), get(backlogOverruns), get(hitsSubsampled), get(hitsMerged), get(hitsThrottled));
+    SKSE::log::info("combat wear: {} hits accumulated, {} degrades applied", get(wearAccumulated), get(wearFlushes));
+    SKSE::log::info("shadow health: {} degrades absorbed, {} deferred writes, {} resyncs", get(shadowAbsorbed), get(shadowWrites), get(shadowResyncs));
+    SKSE::log::info("destroy: {} events, {} RemoveItem calls, {} merged removals", get(destroyEvents), get(removeItemCalls), get(removalsMerged));
+    SKSE::log::info("armor updates: {} degrades, {} flushes", get(armorMarks), get(armorFlushes));
+    SKSE::log::info("gear cache: {} hits, {} misses, {} invalidations", get(gearHits), get(gearMisses), get(gearInvalidations));
+    SKSE::log::info("inventory index: {} builds, {} invalidations", get(inventoryBuilds), get(inventoryInvalidations));
+    SKSE::log::info("worn locator: {} hits, {} misses", get(wornHits), get(wornMisses));
+    SKSE::log::info("resist snapshots: {} hits, {} refreshes", get(resistHits), get(resistRefreshes));
+    SKSE::log::info("base containers: {} late builds", get(containerBuilds));
+}
+
+Stats *Stats::GetSingleton()
+{
+    static Stats singleton;
+    return std::addressof(singleton);
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace DurabilityNG {
+
+using Counter = std::atomic<std::uint64_t>;
+
+inline void Count(Counter& c, std::uint64_t n = 1) {
+    c.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline void CountMax(Counter& c, std::uint64_t n) {
+    auto cur = c.load(std::memory_order_relaxed);
+    while (cur < n && !c.compare_exchange_weak(cur, n, std::memory_order_relaxed));
+}
+
+// Diagnostic counters, written to the log on save.
+class Stats {
+    public:
+        // hit queue
+        Counter hitsQueued{0};
+        Counter hitsOverflow{0};
+        Counter drains{0};
+        Counter priorityHits{0};
+        Counter deferredHits{0}; // hits carried over to a later frame, per frame
+        Counter maxBacklog{0};
+        Counter backlogOverruns{0}; // hits run over budget to keep the backlog at MaxBacklog
+        Counter hitsSubsampled{0}; // distant NPC hits skipped by [Subsample]
+        Counter hitsMerged{0};     // extra hits of one swing
+        Counter hitsThrottled{0};  // defender over the HitRate limit
+        // combat wear
+        Counter wearAccumulated{0};
+        Counter wearFlushes{0};
+        // shadow health
+        Counter shadowAbsorbed{0};
+        Counter shadowWrites{0};
+        Counter shadowResyncs{0};
+        // destroy stage
+        Counter destroyEvents{0};
+        Counter removeItemCalls{0};
+        Counter removalsMerged{0};
+        // armor rating updates
+        Counter armorMarks{0};
+        Counter armorFlushes{0};
+        // equipped gear cache
+        Counter gearHits{0};
+        Counter gearMisses{0};
+        Counter gearInvalidations{0};
+        // inventory index
+        Counter inventoryBuilds{0};
+        Counter inventoryInvalidations{0};
+        // worn extra data locator
+        Counter wornHits{0};
+        Counter wornMisses{0};
+        // damage resist snapshots
+        Counter resistHits{0};
+        Counter resistRefreshes{0};
+        // base containers added after data load
+        Counter containerBuilds{0};
+
+        void Log() const;
+
+        static Stats* GetSingleton();
+};
+
+}
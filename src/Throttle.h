@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "FlatMap.h"
+#include "Stats.h"
+
+namespace DurabilityNG {
+
+// Sweep attacks and multi-hit spells send several hits for one swing within
+// a few milliseconds. The first hit opens a window for its attacker and
+// source; later hits within it add Settings::multiHitFactor times their wear
+// and raise the hit count, and the window is closed with one degrade of the
+// combined wear. Direct-mapped by (attacker, source) so it never allocates; a
+// colliding swing closes the window it replaces, so no wear is lost. Swing is
+// what the close callback needs to apply it. The time is passed in.
+template <class Swing>
+class SwingFilter {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // close(attacker, swing, wear, hits), wear in units of one hit
+        template <class Close>
+        void Hit(std::uint32_t attacker, std::uint32_t source, const Swing& swing, float hits, float factor,
+                 Clock::time_point now, Clock::duration window, Close&& close) {
+            auto& slot = _slots[Index(attacker, source)];
+            if (slot.hits > 0.0f) {
+                if (slot.attacker == attacker && slot.source == source && now - slot.start < window) {
+                    Count(Stats::GetSingleton()->hitsMerged);
+                    slot.wear += factor * hits;
+                    slot.hits += hits;
+                    return;
+                }
+                Finish(slot, close);
+            }
+            slot = {attacker, source, now, swing, hits, hits};
+            _open++;
+        };
+
+        // closes the windows that ran out
+        template <class Close>
+        void Expire(Clock::time_point now, Clock::duration window, Close&& close) {
+            if (!_open) return;
+            for (auto& slot : _slots)
+                if (slot.hits > 0.0f && now - slot.start >= window) Finish(slot, close);
+        };
+        std::size_t Open() const { return _open; };
+        void Clear() {
+            _slots = {};
+            _open = 0;
+        };
+
+    private:
+        static constexpr int kBits = 8;
+        static std::size_t Index(std::uint32_t attacker, std::uint32_t source) {
+            return static_cast<std::size_t>(((std::uint64_t(attacker) << 32 | source) * 0x9E3779B97F4A7C15ull) >> (64 - kBits));
+        };
+        struct Slot {
+            std::uint32_t attacker = 0;
+            std::uint32_t source = 0;
+            Clock::time_point start;
+            Swing swing{};
+            float wear = 0.0f;
+            float hits = 0.0f; // 0 = no open window
+        };
+        template <class Close>
+        void Finish(Slot& slot, Close& close) {
+            const float wear = slot.wear, hits = slot.hits;
+            slot.hits = 0.0f;
+            _open--;
+            close(slot.attacker, slot.swing, wear, hits);
+        };
+        std::array<Slot, 1 << kBits> _slots{};
+        std::size_t _open = 0;
+};
+
+// Token bucket per defender, refilled at Settings::hitRate per second up to
+// hitBurst. Hits over the limit skip the defense and destroy stages and are
+// added to the next hit that gets through, so expected wear is unchanged.
+// Buckets that are full again and hold no skipped hits are pruned once the
+// map grows; the time is passed in.
+class HitLimiter {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // hits the current one stands for after folding in the skipped ones,
+        // 0 if it is over the limit
+        float Take(std::uint32_t defender, float hits, Clock::time_point now, float rate, float burst) {
+            if (_buckets.Size() >= _pruneAt) Prune(now, rate, burst);
+            auto& bucket = _buckets[defender];
+            if (bucket.last == Clock::time_point{})
+                bucket.tokens = burst;
+            else
+                bucket.tokens = Refill(bucket, now, rate, burst);
+            bucket.last = now;
+            bucket.pending += hits;
+            if (bucket.tokens < 1.0f) {
+                Count(Stats::GetSingleton()->hitsThrottled);
+                return 0.0f;
+            }
+            bucket.tokens -= 1.0f;
+            return std::exchange(bucket.pending, 0.0f);
+        };
+        std::size_t Size() const { return _buckets.Size(); };
+        void Clear() {
+            _buckets.Clear();
+            _pruneAt = kPruneAt;
+        };
+
+    private:
+        static constexpr std::size_t kPruneAt = 256;
+        struct Bucket {
+            float tokens = 0.0f;
+            float pending = 0.0f;
+            Clock::time_point last;
+        };
+        static float Refill(const Bucket& bucket, Clock::time_point now, float rate, float burst) {
+            return std::min(burst, bucket.tokens + rate * std::chrono::duration<float>(now - bucket.last).count());
+        };
+        // a pruned bucket is the same as a new one; the threshold follows the
+        // live buckets so a busy map is not scanned on every hit
+        void Prune(Clock::time_point now, float rate, float burst) {
+            std::vector<std::uint32_t> idle;
+            _buckets.ForEach([&](std::uint32_t defender, const Bucket& bucket) {
+                if (!bucket.pending && Refill(bucket, now, rate, burst) >= burst) idle.push_back(defender);
+            });
+            for (const auto defender : idle) _buckets.Erase(defender);
+            _pruneAt = std::max(kPruneAt, 2 * _buckets.Size());
+        };
+        Tools::FlatMap<std::uint32_t, Bucket> _buckets;
+        std::size_t _pruneAt = kPruneAt;
+};
+
+}
@@ -1,25 +1,128 @@
 #pragma once
 
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <limits>
 #include <random>
 #include <type_traits>
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 namespace Tools {
 
-    template<class T>
-    using uniform_distribution = typename std::conditional<
-        std::is_floating_point<T>::value,
-        std::uniform_real_distribution<T>,
-        typename std::conditional<
-            std::is_integral<T>::value,
-            std::uniform_int_distribution<T>,
-            void
-        >::type
-    >::type;
+    // xoshiro256++ (Blackman & Vigna): 32 bytes of state, a few cycles per
+    // draw. Satisfies UniformRandomBitGenerator, so std distributions work.
+    class Xoshiro256pp {
+        public:
+            using result_type = std::uint64_t;
+
+            explicit Xoshiro256pp(std::uint64_t seed = 0) { Seed(seed); };
+
+            // expand one word into the full state with splitmix64
+            void Seed(std::uint64_t seed) {
+                for (auto& s : _s) {
+                    std::uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+                    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                    s = z ^ (z >> 31);
+                }
+            };
+
+            inline result_type operator()() {
+                const auto res = std::rotl(_s[0] + _s[3], 23) + _s[0];
+                const auto t = _s[1] << 17;
+                _s[2] ^= _s[0];
+                _s[3] ^= _s[1];
+                _s[1] ^= _s[2];
+                _s[0] ^= _s[3];
+                _s[2] ^= t;
+                _s[3] = std::rotl(_s[3], 45);
+                return res;
+            };
+
+            static constexpr result_type min() { return 0; };
+            static constexpr result_type max() { return std::numeric_limits<result_type>::max(); };
+
+        private:
+            std::uint64_t _s[4];
+    };
+
+    using Engine = Xoshiro256pp;
+
+    namespace detail {
+        inline std::atomic<std::uint64_t>& SeedBase() {
+            static std::atomic<std::uint64_t> base{
+                (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}()
+            };
+            return base;
+        };
+
+        inline std::uint64_t MulHi(std::uint64_t a, std::uint64_t b, std::uint64_t& lo) {
+#if defined(_MSC_VER) && !defined(__clang__)
+            std::uint64_t hi;
+            lo = _umul128(a, b, &hi);
+            return hi;
+#else
+            const auto p = static_cast<unsigned __int128>(a) * b;
+            lo = static_cast<std::uint64_t>(p);
+            return static_cast<std::uint64_t>(p >> 64);
+#endif
+        };
+
+        // uniform in [0, range) without division in the common case (Lemire)
+        template <class E>
+        inline std::uint64_t Bounded(E& engine, std::uint64_t range) {
+            std::uint64_t lo;
+            auto hi = MulHi(engine(), range, lo);
+            if (lo < range) {
+                const auto threshold = (0 - range) % range;
+                while (lo < threshold)
+                    hi = MulHi(engine(), range, lo);
+            }
+            return hi;
+        };
+    }
+
+    // Per-thread engine. Each thread gets its own stream derived from the
+    // seed base, so no thread touches std::random_device after the first.
+    inline Engine& ThreadEngine() {
+        thread_local Engine engine{ detail::SeedBase().fetch_add(0x9E3779B97F4A7C15ull) };
+        return engine;
+    };
+
+    // Reseed the calling thread and the base for threads created later, so
+    // tests and replays see the same sequence.
+    inline void Seed(std::uint64_t seed) {
+        detail::SeedBase().store(seed + 0x9E3779B97F4A7C15ull);
+        ThreadEngine().Seed(seed);
+    };
+
+    // Same contract as the std distributions it replaces: integers are drawn
+    // from [min, max], floating point values from [min, max).
+    template <typename T, std::uniform_random_bit_generator E>
+    T RandU(E& engine, T max = 1, T min = 0) {
+        static_assert(std::is_arithmetic_v<T>);
+        if constexpr (std::is_floating_point_v<T>) {
+            double u;
+            if constexpr (std::is_same_v<T, float>)
+                u = (engine() >> 40) * 0x1.0p-24;
+            else
+                u = (engine() >> 11) * 0x1.0p-53;
+            return static_cast<T>(min + u * (max - min));
+        } else {
+            const auto range = static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min) + 1;
+            if (!range) return static_cast<T>(engine());
+            return static_cast<T>(static_cast<std::uint64_t>(min) + detail::Bounded(engine, range));
+        }
+    };
 
     template <typename T>
     T RandU(T max = 1, T min = 0) {
-        thread_local std::mt19937_64 mt{ std::random_device{}() };
-        return uniform_distribution<T>(min, max)(mt);
+        return RandU<T>(ThreadEngine(), max, min);
     };
-   
-}
\ No newline at end of file
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "Stats.h"
+
+namespace RE {
+    class InventoryEntryData;
+    class ExtraDataList;
+    class ExtraHealth;
+}
+
+namespace DurabilityNG {
+
+// worn extra data list of an inventory entry, per hand
+struct WornSlot {
+    const RE::InventoryEntryData* entry;
+    bool left;
+    RE::ExtraDataList* list;
+    RE::ExtraHealth* health;
+};
+
+// The worn lists found for one actor. The pointers are only valid until the
+// next equip or container change, whose sinks clear valid.
+struct WornSlots {
+    std::vector<WornSlot> slots;
+    bool valid = false;
+
+    // locate(entry, left) returns the {list, health} pair on a miss
+    template <class Locate>
+    WornSlot* Find(RE::InventoryEntryData* entry, bool left, Locate&& locate) {
+        if (!valid) {
+            slots.clear();
+            valid = true;
+        }
+        for (auto& slot : slots)
+            if (slot.entry == entry && slot.left == left) {
+                Count(Stats::GetSingleton()->wornHits);
+                return slot.list ? &slot : nullptr;
+            }
+        Count(Stats::GetSingleton()->wornMisses);
+        const auto [list, health] = locate(entry, left);
+        auto& slot = slots.emplace_back(entry, left, list, health);
+        return list ? &slot : nullptr;
+    };
+};
+
+}
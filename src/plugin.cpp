@@ -1,5 +1,8 @@
+#include "Cache.h"
 #include "Events.h"
+#include "Serialization.h"
 #include "Settings.h"
+#include "Stats.h"
 
 #include <spdlog/sinks/basic_file_sink.h>
 
@@ -22,6 +25,7 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
 	case SKSE::MessagingInterface::kDataLoaded: {
 		auto pluginName = SKSE::PluginDeclaration::GetSingleton()->GetName();
 		DurabilityNG::InitSettings(std::format("Data/SKSE/Plugins/{}.ini", pluginName).c_str());
+		DurabilityNG::InitCaches();
 		DurabilityNG::InitEvents();
 		break;
 	}
@@ -33,6 +37,11 @@ void MessageHandler(SKSE::MessagingInterface::Message* a_msg)
         break;
 	case SKSE::MessagingInterface::kNewGame:
 		break;
+	case SKSE::MessagingInterface::kSaveGame:
+		// keeps the base save correct without the co-save
+		DurabilityNG::ShadowHealth::GetSingleton()->SyncAll();
+		DurabilityNG::Stats::GetSingleton()->Log();
+		break;
 	}
 }
 
@@ -42,6 +51,7 @@ SKSEPluginLoad(const SKSE::LoadInterface *skse) {
 
     auto messaging = SKSE::GetMessagingInterface();
 	if (!messaging->RegisterListener("SKSE", MessageHandler)) return false;
+	DurabilityNG::InitSerialization();
 	
     return true;
 }
\ No newline at end of file
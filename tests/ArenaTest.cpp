@@ -0,0 +1,101 @@
+#include "Arena.h"
+#include "Pick.h"
+#include "Check.h"
+
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// every global allocation in the process is counted
+static std::atomic<std::size_t> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs++;
+    if (auto p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t n, std::align_val_t align) {
+    g_allocs++;
+    const auto a = static_cast<std::size_t>(align);
+    if (auto p = std::aligned_alloc(a, (n + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace DurabilityNG;
+
+struct Item {
+    const void* form;
+    std::int32_t count;
+};
+
+// what the destroy stage does per hit: fill a PickList from the inventory,
+// pull until the resist roll stops, build the notification text
+template <class Policy>
+std::size_t Hit(std::size_t inventory, unsigned reserve) {
+    Tools::Arena arena;
+    auto pick = PickList<Item, float, Policy>(reserve, arena.get());
+    for (std::size_t i = 0; i < inventory; i++)
+        pick.Push({&pick, static_cast<std::int32_t>(i % 3 + 1)}, 1.0f + i % 7);
+    std::pmr::string msg{arena.get()};
+    msg.reserve(130);
+    std::size_t pulled = 0;
+    while (auto item = pick.Pull()) {
+        if (!msg.empty()) msg += ", ";
+        char num[16];
+        msg.append(num, std::to_chars(num, num + sizeof(num), item->count).ptr);
+        msg += " Iron Dagger";
+        pulled++;
+        if (Tools::RandU<float>() < 0.2f) break;
+    }
+    msg.insert(0, "Destroyed ");
+    Test::Keep(msg.data());
+    return pulled;
+}
+
+int main() {
+    // warm up: thread-local buffer, RNG, first-use statics
+    for (int i = 0; i < 100; i++) {
+        Hit<LinearPick>(100, 100);
+        Hit<FenwickPick>(100, 100);
+        Hit<LinearPick>(20, 20);
+    }
+
+    const auto before = g_allocs.load();
+    std::size_t pulled = 0;
+    for (int i = 0; i < 10'000; i++) {
+        pulled += Hit<LinearPick>(100, 100);  // player
+        pulled += Hit<FenwickPick>(100, 100); // the other policy
+        pulled += Hit<LinearPick>(20, 20);    // NPC
+    }
+    CHECK(pulled > 0);
+    CHECK(g_allocs.load() == before);
+
+    // outgrowing the buffer falls back to the heap and still works
+    const auto big = g_allocs.load();
+    CHECK(Hit<FenwickPick>(4000, 4000) > 0);
+    CHECK(g_allocs.load() > big);
+
+    // a nested arena gets no buffer but leaves the outer one intact
+    {
+        Tools::Arena outer;
+        std::pmr::vector<int> a(100, 1, outer.get());
+        {
+            Tools::Arena inner;
+            std::pmr::vector<int> b(100, 2, inner.get());
+            CHECK(b[99] == 2);
+        }
+        CHECK(a[99] == 1);
+    }
+    const auto after = g_allocs.load();
+    Hit<LinearPick>(20, 20);
+    CHECK(g_allocs.load() == after);
+
+    std::printf("Arena: %zu steady-state hits without heap allocations\n", std::size_t(30'000));
+    return 0;
+}
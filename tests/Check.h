@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+// Assertion for the standalone tests: reports the expression and exits
+// non-zero, in release builds too.
+#define CHECK(expr)                                                                  \
+    do {                                                                             \
+        if (!(expr)) {                                                               \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::exit(1);                                                            \
+        }                                                                            \
+    } while (false)
+
+namespace Test {
+
+    // keeps the optimizer from dropping a benchmarked result
+    template <class T>
+    inline void Keep(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    };
+
+    // chi-square statistic of observed counts against expected counts
+    template <class O, class E>
+    double ChiSquare(const O& observed, const E& expected) {
+        double chi = 0;
+        for (std::size_t i = 0; i < std::size(observed); i++) {
+            const double d = observed[i] - expected[i];
+            chi += d * d / expected[i];
+        }
+        return chi;
+    };
+
+    // critical value at p = 0.001 (Wilson-Hilferty), so a correct sampler
+    // with a fixed seed passes and a biased one fails clearly
+    inline double ChiSquareCritical(double df) {
+        const double a = 2.0 / (9.0 * df);
+        return df * std::pow(1.0 - a + 3.09 * std::sqrt(a), 3);
+    };
+
+    // nanoseconds per call of func, which runs n operations per call
+    template <class F>
+    double NsPerOp(std::size_t calls, std::size_t n, F&& func) {
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < calls; i++) func();
+        const std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+        return took.count() / (double(calls) * n);
+    };
+
+}
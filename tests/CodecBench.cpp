@@ -0,0 +1,66 @@
+#include "Codec.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <chrono>
+
+using namespace DurabilityNG;
+
+// a co-save of 100k shadow records, the worst case of a long session with
+// a tiny WriteBackStep: encode and decode time and bytes per record
+int main() {
+    constexpr std::size_t kRecords = 100'000;
+    Tools::Seed(23);
+    struct Row { std::uint32_t actor, form; bool left; float health, written; };
+    std::vector<Row> rows;
+    std::uint32_t actor = 0x14;
+    for (std::size_t i = 0; i < kRecords; i++) {
+        if (Tools::RandU<int>(9) == 0) actor += Tools::RandU<std::uint32_t>(0x4000, 1);
+        rows.push_back({actor, 0, Tools::RandU<int>(1) == 1, Tools::RandU<float>(1.0f), Tools::RandU<float>(1.0f)});
+    }
+    std::uint32_t form = 0;
+    for (std::size_t i = 0; i < kRecords; i++) {
+        if (i && rows[i].actor != rows[i - 1].actor) form = 0;
+        rows[i].form = form += Tools::RandU<std::uint32_t>(0x800, 1);
+    }
+
+    constexpr int kRuns = 20;
+    std::size_t bytes = 0;
+    const double encodeNs = Test::NsPerOp(kRuns, kRecords, [&]() {
+        Writer out;
+        out.Varint(rows.size());
+        PairDelta ids;
+        for (const auto& r : rows) {
+            ids.Write(out, r.actor, r.form);
+            out.U8(r.left);
+            out.Health(r.health);
+            out.Health(r.written);
+        }
+        bytes = out.Size();
+        Test::Keep(out.Data().data());
+    });
+
+    Writer out;
+    out.Varint(rows.size());
+    PairDelta ids;
+    for (const auto& r : rows) {
+        ids.Write(out, r.actor, r.form);
+        out.U8(r.left);
+        out.Health(r.health);
+        out.Health(r.written);
+    }
+    float sum = 0;
+    const double decodeNs = Test::NsPerOp(kRuns, kRecords, [&]() {
+        Reader in(out.Data());
+        PairDelta back;
+        for (auto n = in.Varint(); n && in.ok; n--) {
+            const auto [a, f] = back.Read(in);
+            sum += a + f + in.U8() + in.Health() + in.Health();
+        }
+        CHECK(in.ok);
+    });
+    Test::Keep(sum);
+    std::printf("co-save, %zu shadow records: %.2f bytes each, encode %.1f ns, decode %.1f ns per record (%.2f / %.2f ms)\n",
+        kRecords, double(bytes) / kRecords, encodeNs, decodeNs, encodeNs * kRecords / 1e6, decodeNs * kRecords / 1e6);
+    return 0;
+}
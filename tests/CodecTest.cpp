@@ -0,0 +1,89 @@
+#include "Codec.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <tuple>
+
+using namespace DurabilityNG;
+
+struct Row {
+    std::uint32_t actor, form;
+    bool left;
+    float health, written;
+};
+
+int main() {
+    Tools::Seed(23);
+
+    // varints at the 7-bit boundaries
+    {
+        Writer out;
+        const std::uint64_t values[] = {0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0xFFFFFFFF, ~0ull};
+        for (auto v : values) out.Varint(v);
+        CHECK(out.Size() == 1 + 1 + 1 + 2 + 2 + 3 + 5 + 10);
+        Reader in(out.Data());
+        for (auto v : values) CHECK(in.Varint() == v);
+        CHECK(in.ok);
+        in.U8();
+        CHECK(!in.ok);
+    }
+
+    // a shadow record: sorted actor/form pairs with plugin and runtime
+    // (0xFF) FormIDs, several forms per actor
+    std::vector<Row> rows;
+    for (int i = 0; i < 5000; i++) {
+        const std::uint32_t actor = Tools::RandU<int>(3) == 0 ? 0x14 : (Tools::RandU<std::uint32_t>(0xFF) << 24 | Tools::RandU<std::uint32_t>(0xFFFFFF));
+        const std::uint32_t form = Tools::RandU<std::uint32_t>(0xFF) << 24 | Tools::RandU<std::uint32_t>(0xFFFFFF);
+        rows.push_back({actor, form, Tools::RandU<int>(1) == 1, Tools::RandU<float>(8.0f), Tools::RandU<float>(8.0f)});
+    }
+    std::ranges::sort(rows, {}, [](const Row& r) { return std::tuple(r.actor, r.form, r.left); });
+
+    Writer out;
+    out.Varint(rows.size());
+    PairDelta ids;
+    for (const auto& r : rows) {
+        ids.Write(out, r.actor, r.form);
+        out.U8(r.left);
+        out.Health(r.health);
+        out.Health(r.written);
+        out.F32(r.health);
+    }
+
+    Reader in(out.Data());
+    CHECK(in.Varint() == rows.size());
+    PairDelta back;
+    for (const auto& r : rows) {
+        const auto [actor, form] = back.Read(in);
+        CHECK(actor == r.actor);
+        CHECK(form == r.form);
+        CHECK(static_cast<bool>(in.U8()) == r.left);
+        // 16-bit health stays within one step (half of one, rounded)
+        CHECK(std::abs(in.Health() - r.health) <= kHealthQuantum / 2);
+        CHECK(std::abs(in.Health() - r.written) <= kHealthQuantum / 2);
+        CHECK(in.F32() == r.health);
+    }
+    CHECK(in.ok);
+
+    // health outside 0..8 is clamped, not wrapped
+    {
+        Writer w;
+        w.Health(-1.0f);
+        w.Health(100.0f);
+        Reader r(w.Data());
+        CHECK(r.Health() == 0.0f);
+        CHECK(r.Health() == 0xFFFF * kHealthQuantum);
+    }
+
+    // a truncated record reads zeros and reports it
+    auto cut = out.Data();
+    cut.resize(cut.size() / 2);
+    Reader part(cut);
+    part.Varint();
+    PairDelta ids2;
+    for (std::size_t i = 0; i < rows.size() && part.ok; i++) {
+        ids2.Read(part);
+        part.U8(); part.Health(); part.Health(); part.F32();
+    }
+    CHECK(!part.ok);
+    return 0;
+}
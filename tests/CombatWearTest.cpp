@@ -0,0 +1,63 @@
+#include "Sampling.h"
+#include "PowTable.h"
+#include "Check.h"
+
+using namespace DurabilityNG;
+
+// An NPC fight of `hits` equal degrades against one item, processed per hit
+// and as one CombatWear flush. Break chance per degrade is 1 - survival(x)
+// at the health x it leaves, with Break.ExponentLow 0.25 and Break 1.1 as in
+// Settings::Degrade, so items start to break below 0.68 health.
+constexpr float kMinHealth = 0.01f;
+constexpr float kExponent = 0.25f;
+constexpr float kBreak = 1.1f;
+
+struct Outcome {
+    double broken = 0;
+    double health = 0; // mean health of the items that survived
+};
+
+int main() {
+    Tools::Seed(21);
+    PowTable curve;
+    curve.Build(kMinHealth, 1.0f, kExponent);
+    auto survival = [&](float x) { return kBreak * curve(std::max(kMinHealth, x)); };
+
+    constexpr int kFights = 200'000;
+    for (const auto [hits, wear] : {std::pair(10, 0.01f), std::pair(40, 0.015f), std::pair(100, 0.006f), std::pair(8, 0.1f), std::pair(3, 0.3f)}) {
+        Outcome perHit, flushed, atEnd;
+        for (int f = 0; f < kFights; f++) {
+            float x = 1.0f;
+            bool broken = false;
+            for (int i = 0; i < hits && !broken; i++) {
+                x = std::max(kMinHealth, x - wear);
+                broken = !(survival(x) > Tools::RandU<float>());
+            }
+            perHit.broken += broken;
+            if (!broken) perHit.health += x;
+        }
+        // the flush: one Degrade with the summed wear, standing for all hits
+        const float cur = std::max(kMinHealth, 1.0f - wear * hits);
+        for (int f = 0; f < kFights; f++) {
+            const bool broken = !(PathSurvival(1.0f, 1.0f - wear * hits, float(hits), survival) > Tools::RandU<float>());
+            flushed.broken += broken;
+            if (!broken) flushed.health += cur;
+            atEnd.broken += !(std::pow(std::min(1.0f, survival(cur)), float(hits)) > Tools::RandU<float>());
+        }
+        const double pPerHit = perHit.broken / kFights, pFlushed = flushed.broken / kFights, pAtEnd = atEnd.broken / kFights;
+        std::printf("%2d hits of %.3f: broken per hit %.4f, flushed %.4f, at final health only %.4f\n",
+            hits, wear, pPerHit, pFlushed, pAtEnd);
+        CHECK(std::abs(pFlushed - pPerHit) < 0.01);
+        // survivors end at the same health either way
+        if (perHit.broken < kFights)
+            CHECK(std::abs(perHit.health / (kFights - perHit.broken) - cur) < 1e-4);
+    }
+
+    // one point per hit up to kPathPoints is exact for equal degrades
+    const float exact = std::min(1.0f, survival(0.6f)) * survival(0.4f) * survival(0.2f);
+    CHECK(std::abs(PathSurvival(0.8f, 0.2f, 3.0f, survival) - exact) < 1e-5);
+    CHECK(PathSurvival(1.0f, 0.99f, 1.0f, survival) == 1.0f);
+    // a fraction of a hit, as HitLimiter folds them, ends at `to`
+    CHECK(PathSurvival(0.8f, 0.2f, 0.5f, survival) == std::pow(survival(0.2f), 0.5f));
+    return 0;
+}
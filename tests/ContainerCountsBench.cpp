@@ -0,0 +1,83 @@
+#include "ContainerCounts.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+
+// every global allocation in the process is counted, as in ArenaTest
+static std::atomic<std::size_t> g_allocs{0};
+
+void* operator new(std::size_t n) {
+    g_allocs++;
+    if (auto p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using namespace DurabilityNG;
+
+struct Form {
+    char data[32];
+};
+// TESContainer::containerObjects, duplicates included
+struct ContainerObject {
+    std::int32_t count;
+    Form* obj;
+};
+
+int main() {
+    Tools::Seed(4);
+    std::vector<std::unique_ptr<Form>> forms;
+    for (int i = 0; i < 200; i++) forms.push_back(std::make_unique<Form>());
+
+    std::printf("base container counts for one destroy roll over a 50-entry inventory:\n");
+    for (const std::size_t objects : {10, 40, 150}) {
+        std::vector<ContainerObject> cont;
+        for (std::size_t i = 0; i < objects; i++)
+            cont.push_back({Tools::RandU<std::int32_t>(5, 1), forms[Tools::RandU<std::size_t>(forms.size() - 1)].get()});
+        std::vector<Form*> inventory;
+        for (int i = 0; i < 50; i++) inventory.push_back(forms[Tools::RandU<std::size_t>(forms.size() - 1)].get());
+
+        // before: a std::map built per roll
+        auto before = [&]() {
+            std::map<Form*, std::int32_t> counts{};
+            for (auto& ent : cont) {
+                const auto& [it, added] = counts.try_emplace(ent.obj, ent.count);
+                if (!added) it->second += ent.count;
+            }
+            std::int32_t sum = 0;
+            for (auto* obj : inventory)
+                if (auto it = counts.find(obj); it != counts.end()) sum += it->second;
+            return sum;
+        };
+        // after: the table BaseContainers built at data load
+        std::vector<FormCount<Form>> table;
+        for (auto& ent : cont) table.push_back({ent.obj, ent.count});
+        MergeCounts(table);
+        const std::span<const FormCount<Form>> counts(table);
+        auto after = [&]() {
+            std::int32_t sum = 0;
+            for (auto* obj : inventory) sum += FindCount(counts, obj);
+            return sum;
+        };
+        CHECK(before() == after());
+
+        constexpr std::size_t kRolls = 100'000;
+        std::int32_t sum = 0;
+        auto allocs = g_allocs.load();
+        const double mapNs = Test::NsPerOp(kRolls, 1, [&]() { sum += before(); });
+        const double mapAllocs = double(g_allocs.load() - allocs) / kRolls;
+        allocs = g_allocs.load();
+        const double tableNs = Test::NsPerOp(kRolls, 1, [&]() { sum += after(); });
+        CHECK(g_allocs.load() == allocs);
+        Test::Keep(sum);
+        std::printf("  %3zu container objects: std::map %7.0f ns, %5.1f allocations; table %5.0f ns, 0 allocations\n",
+            objects, mapNs, mapAllocs, tableNs);
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "FlatMap.h"
+#include "Pick.h"
+#include "Check.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace DurabilityNG;
+
+// DestroyItems weighs every inventory entry. It used to compute
+// GetWeight() * pow(GetMult(form), Destroy.MaterialExponent) per entry; now
+// the product is precomputed in the form table row next to the multiplier.
+// GetWeight is a virtual call on TESBoundObject, modelled as one here.
+struct Form {
+    virtual ~Form() = default;
+    virtual float GetWeight() const { return weight; };
+    std::uint32_t formID;
+    float weight;
+    char rest[48];
+};
+struct Row {
+    const Form* form;
+    float mult;
+    float destroyWeight;
+};
+struct Entry {
+    Form* object;
+    std::int32_t countDelta;
+};
+
+int main() {
+    Tools::Seed(11);
+    constexpr std::size_t kEntries = 1'000;
+    constexpr float kExponent = 0.5f;
+    std::vector<std::unique_ptr<Form>> forms;
+    Tools::FlatMap<std::uint32_t, std::uint32_t> formIndex;
+    std::vector<Row> formTable;
+    // a load order's worth of forms, the inventory holds 1,000 of them
+    for (std::uint32_t i = 0; i < 20'000; i++) {
+        auto form = std::make_unique<Form>();
+        form->formID = 0x00012E00 + i * 13;
+        form->weight = Tools::RandU<float>(30.0f, 0.1f);
+        const float mult = Tools::RandU<float>(4.0f, 0.5f);
+        formIndex[form->formID] = static_cast<std::uint32_t>(formTable.size());
+        formTable.push_back({form.get(), mult, form->weight * std::pow(mult, kExponent)});
+        forms.push_back(std::move(form));
+    }
+    std::vector<Entry> inventory;
+    for (std::size_t i = 0; i < kEntries; i++)
+        inventory.push_back({forms[Tools::RandU<std::size_t>(forms.size() - 1)].get(), Tools::RandU<std::int32_t>(5, 1)});
+
+    auto row = [&](const Form* form) -> const Row& { return formTable[*formIndex.Find(form->formID)]; };
+    float sumOld = 0, sumNew = 0;
+    // the candidate weights alone, and the whole build of the PickList
+    const double oldNs = Test::NsPerOp(2'000, kEntries, [&]() {
+        for (const auto& e : inventory)
+            sumOld += e.object->GetWeight() * std::pow(row(e.object).mult, kExponent) * e.countDelta;
+    });
+    const double newNs = Test::NsPerOp(2'000, kEntries, [&]() {
+        for (const auto& e : inventory)
+            sumNew += row(e.object).destroyWeight * e.countDelta;
+    });
+    const double oldListNs = Test::NsPerOp(2'000, kEntries, [&]() {
+        PickList<const Form*, float, LinearPick> pick(kEntries);
+        for (const auto& e : inventory)
+            pick.Push(static_cast<const Form*>(e.object), e.object->GetWeight() * std::pow(row(e.object).mult, kExponent) * e.countDelta);
+        Test::Keep(pick);
+    });
+    const double newListNs = Test::NsPerOp(2'000, kEntries, [&]() {
+        PickList<const Form*, float, LinearPick> pick(kEntries);
+        for (const auto& e : inventory)
+            pick.Push(static_cast<const Form*>(e.object), row(e.object).destroyWeight * e.countDelta);
+        Test::Keep(pick);
+    });
+    Test::Keep(sumOld);
+    Test::Keep(sumNew);
+    CHECK(std::abs(sumOld - sumNew) <= 1e-3 * sumOld);
+    std::printf("destroy weights over %zu entries, ns per entry: weight * pow(mult) %.1f, table row %.1f\n", kEntries, oldNs, newNs);
+    std::printf("  with the PickList build: weight * pow(mult) %.1f, table row %.1f\n", oldListNs, newListNs);
+    return 0;
+}
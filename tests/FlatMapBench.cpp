@@ -0,0 +1,72 @@
+#include "FlatMap.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// What FindEntry replaced: InventoryChanges::entryList is a singly linked
+// list (BSSimpleList) of heap-allocated entries, walked until the entry for
+// the form turns up. The index is a FlatMap from form to entry.
+struct Form {
+    char data[64];
+};
+struct Entry {
+    Form* object;
+    std::int32_t countDelta;
+    char rest[16];
+};
+struct Node {
+    Entry* item;
+    Node* next;
+};
+
+int main() {
+    Tools::Seed(3);
+    std::printf("inventory lookup, ns per call:\n");
+    for (const std::size_t n : {10, 100, 1'000, 10'000}) {
+        std::vector<std::unique_ptr<Form>> forms;
+        std::vector<std::unique_ptr<Entry>> entries;
+        std::vector<std::unique_ptr<Node>> nodes;
+        for (std::size_t i = 0; i < n; i++) {
+            forms.push_back(std::make_unique<Form>());
+            entries.push_back(std::make_unique<Entry>(Entry{forms.back().get(), 1, {}}));
+        }
+        // list order unrelated to allocation order, as after a long session
+        std::vector<Entry*> order;
+        for (auto& e : entries) order.push_back(e.get());
+        for (std::size_t i = n; i > 1; i--) std::swap(order[i - 1], order[Tools::RandU<std::size_t>(i - 1)]);
+        Node* head = nullptr;
+        for (auto* e : order) {
+            nodes.push_back(std::make_unique<Node>(Node{e, head}));
+            head = nodes.back().get();
+        }
+
+        Tools::FlatMap<const Form*, Entry*> index;
+        for (auto* node = head; node; node = node->next)
+            if (auto& slot = index[node->item->object]; !slot) slot = node->item;
+
+        std::vector<const Form*> lookups(4096);
+        for (auto& f : lookups) f = forms[Tools::RandU<std::size_t>(n - 1)].get();
+
+        const std::size_t calls = std::max<std::size_t>(2'000, 20'000'000 / n);
+        std::size_t i = 0;
+        std::int32_t sum = 0;
+        const double walk = Test::NsPerOp(calls, 1, [&]() {
+            const auto* form = lookups[i++ & 4095];
+            for (auto* node = head; node; node = node->next)
+                if (node->item->object == form) {
+                    sum += node->item->countDelta;
+                    break;
+                }
+        });
+        const double flat = Test::NsPerOp(20'000'000, 1, [&]() {
+            sum += (*index.Find(lookups[i++ & 4095]))->countDelta;
+        });
+        Test::Keep(sum);
+        CHECK(sum > 0);
+        std::printf("  %6zu entries: list walk %10.1f, FlatMap %5.1f\n", n, walk, flat);
+    }
+    return 0;
+}
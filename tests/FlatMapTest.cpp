@@ -0,0 +1,83 @@
+#include "FlatMap.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <unordered_map>
+#include <vector>
+
+using Tools::FlatMap;
+
+int main() {
+    Tools::Seed(3);
+
+    // random inserts, lookups and erases against std::unordered_map; a small
+    // key range keeps the table dense, so probe chains run long and erase
+    // has to shift entries back across them
+    for (const std::uint32_t range : {50u, 1000u, 100'000u}) {
+        FlatMap<std::uint32_t, int> map;
+        std::unordered_map<std::uint32_t, int> model;
+        for (int step = 0; step < 300'000; step++) {
+            const auto key = Tools::RandU<std::uint32_t>(range, 1);
+            switch (Tools::RandU<int>(3)) {
+            case 0:
+            case 1:
+                map[key] = step;
+                model[key] = step;
+                break;
+            case 2:
+                CHECK(map.Erase(key) == (model.erase(key) == 1));
+                break;
+            default: {
+                const auto* found = map.Find(key);
+                const auto it = model.find(key);
+                CHECK((found != nullptr) == (it != model.end()));
+                if (found) CHECK(*found == it->second);
+            }
+            }
+            CHECK(map.Size() == model.size());
+        }
+        // every surviving key is still reachable after all the shifting
+        for (const auto& [key, val] : model) {
+            const auto* found = map.Find(key);
+            CHECK(found && *found == val);
+        }
+        std::size_t seen = 0;
+        map.ForEach([&](std::uint32_t key, int val) {
+            CHECK(model.at(key) == val);
+            seen++;
+        });
+        CHECK(seen == model.size());
+    }
+
+    // keys that all hash to one home slot: erasing from the middle of the
+    // chain must keep the rest findable
+    {
+        FlatMap<std::uint64_t, int> map;
+        map.Reserve(8); // 16 slots, Index uses the top 4 bits of key * phi
+        std::vector<std::uint64_t> same;
+        const auto home = [](std::uint64_t k) { return (k * 0x9E3779B97F4A7C15ull) >> 60; };
+        for (std::uint64_t k = 1; same.size() < 6; k++)
+            if (home(k) == home(1)) same.push_back(k);
+        for (std::size_t i = 0; i < same.size(); i++) map[same[i]] = int(i);
+        CHECK(map.Erase(same[2]));
+        CHECK(!map.Erase(same[2]));
+        for (std::size_t i = 0; i < same.size(); i++)
+            CHECK((map.Find(same[i]) != nullptr) == (i != 2));
+        CHECK(*map.Find(same[5]) == 5);
+    }
+
+    // pointer keys, Clear and reuse
+    {
+        std::vector<int> objects(1000);
+        FlatMap<const int*, std::size_t> map;
+        for (std::size_t i = 0; i < objects.size(); i++) map[&objects[i]] = i;
+        for (std::size_t i = 0; i < objects.size(); i++) CHECK(*map.Find(&objects[i]) == i);
+        map.Clear();
+        CHECK(map.Size() == 0);
+        CHECK(!map.Find(&objects[0]));
+        CHECK(!map.Erase(&objects[0]));
+        map[&objects[7]] = 7;
+        CHECK(*map.Find(&objects[7]) == 7);
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "Group.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <bit>
+#include <string>
+
+using namespace DurabilityNG;
+
+// Group::ActorInfo before the table, with the actor queries answered from
+// the trait bits
+struct OldGroup {
+    float Global = 0.0;
+    float Player = 1.0, NPC = 1.0;
+    float Teammate = 0.0;
+    float Essential = 1.0, Protected = 1.0;
+    float Unique = 0.0;
+    float Respawns[2] = {0.0, 1.0};
+    float Power = 3.0;
+    float Sneak = 0.5;
+    float Bash = 1.5;
+    float Block = 0.7;
+
+    GroupActorInfo ActorInfo(ActorTraits traits, std::uint8_t flags) const {
+        float ret = Global;
+        if (traits & kPlayer) ret *= Player;
+        else {
+            ret *= NPC;
+            if (traits & kTeammate) ret *= Teammate;
+            if (traits & kEssential) ret *= Essential;
+            else if (traits & kProtected) ret *= Protected;
+            if (traits & kUnique) ret *= Unique;
+            ret *= Respawns[!!(traits & kRespawns)];
+        }
+        if (flags & 1) ret *= Power;
+        if (flags & 2) ret *= Sneak;
+        if (flags & 4) ret *= Bash;
+        if (flags & 8) ret *= Block;
+        return std::isfinite(ret) && ret > 0.0 ? ret : 0.0;
+    };
+};
+
+void Compare(const Group& group, const OldGroup& old) {
+    for (ActorTraits traits = 0; traits < 1 << kTraitBits; traits++)
+        for (std::uint8_t flags = 0; flags < 16; flags++)
+            CHECK(std::bit_cast<std::uint32_t>(group.ActorInfo(traits, flags)) ==
+                  std::bit_cast<std::uint32_t>(old.ActorInfo(traits, flags)));
+}
+
+int main() {
+    // defaults
+    Compare(Group{}, OldGroup{});
+
+    // random settings, including zeros and values that overflow to inf
+    Tools::Seed(8);
+    for (int round = 0; round < 200; round++) {
+        OldGroup old;
+        float* fields[] = {&old.Global, &old.Player, &old.NPC, &old.Teammate, &old.Essential, &old.Protected,
+            &old.Unique, &old.Respawns[0], &old.Respawns[1], &old.Power, &old.Sneak, &old.Bash, &old.Block};
+        const char* keys[] = {"Global", "Player", "NPC", "Teammate", "Essential", "Protected",
+            "Unique", "RespawnsNot", "Respawns", "Power", "Sneak", "Bash", "Block"};
+        std::string ini = "[Test]\n";
+        for (std::size_t i = 0; i < std::size(fields); i++) {
+            const auto pick = Tools::RandU<int>(9);
+            const double v = pick == 0 ? 0.0 : pick == 1 ? 1e30 : Tools::RandU<double>(10.0);
+            char line[64];
+            std::snprintf(line, sizeof(line), "%s = %.17g\n", keys[i], v);
+            ini += line;
+            *fields[i] = static_cast<float>(v);
+        }
+        CSimpleIniA parsed;
+        CHECK(parsed.LoadData(ini) == SI_OK);
+        Group group;
+        group.Load(parsed, "Test");
+        Compare(group, old);
+    }
+    std::puts("Group: table matches the per-hit evaluation bit for bit");
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "FlatMap.h"
+#include "Materials.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Degrade and every destroy candidate ask for a form's material multiplier.
+// Before the form table, each call probed kw2mul once per keyword of the form
+// and took the sqrt/cbrt/pow of the material product. Now it is a FormID
+// lookup in formIndex and a read of the formTable row. Forms missing from the
+// table (created after data load) fold their keywords into a KeywordBits mask
+// and MaterialMults sums the logs, with one exp.
+struct Keyword {
+    std::uint32_t formID;
+    char rest[32];
+};
+struct Form {
+    std::uint32_t formID;
+    std::vector<const Keyword*> keywords;
+};
+struct Row {
+    const Form* form;
+    float mult;
+    float destroyWeight;
+};
+
+std::unordered_map<std::uint32_t, float> kw2mul;
+float noMaterialMult = 2.5;
+
+float OldMult(const Form* form) {
+    float oth = 1.0;
+    float mat = 1.0;
+    int materials = 0;
+    for (const auto* kw : form->keywords) {
+        const auto val = kw2mul.find(kw->formID);
+        if (val != kw2mul.cend()) {
+            if (val->second == 0.0) return 0.0;
+            if (val->second > 0.0) {
+                materials++;
+                mat *= val->second;
+            } else
+                oth *= -val->second;
+        }
+    }
+    switch (materials) {
+        case 0: mat = noMaterialMult; break;
+        case 1: break;
+        case 2: mat = std::sqrt(mat); break;
+        case 3: mat = std::cbrt(mat); break;
+        default: mat = std::pow(mat, 1.0 / materials); break;
+    }
+    return mat * oth;
+}
+
+int main() {
+    Tools::Seed(9);
+    // roughly the vanilla + DLC armor set: ~1100 ARMO forms with 3-6
+    // keywords each out of ~90 (about 30 of them ArmorMaterial*); a third
+    // are clothing and jewelry without a material, a few have two
+    std::vector<std::unique_ptr<Keyword>> keywords;
+    for (std::uint32_t i = 0; i < 90; i++)
+        keywords.push_back(std::make_unique<Keyword>(Keyword{0x0006BB00 + i * 7, {}}));
+    DurabilityNG::MaterialMults mults;
+    for (std::size_t i = 0; i < 30; i++) {
+        kw2mul[keywords[i]->formID] = Tools::RandU<float>(2.0f, 0.5f);
+        mults.Add(keywords[i]->formID, kw2mul[keywords[i]->formID]);
+    }
+
+    constexpr std::size_t kForms = 1100;
+    std::vector<std::unique_ptr<Form>> forms;
+    for (std::uint32_t i = 0; i < kForms; i++) {
+        auto form = std::make_unique<Form>();
+        form->formID = 0x00012E00 + i * 13;
+        const auto roll = Tools::RandU<float>();
+        if (roll < 0.62f) form->keywords.push_back(keywords[Tools::RandU<std::size_t>(29)].get());
+        else if (roll < 0.67f)
+            for (int m = 0; m < 2; m++) form->keywords.push_back(keywords[Tools::RandU<std::size_t>(29)].get());
+        for (auto k = Tools::RandU<int>(5, 2); k > 0; k--)
+            form->keywords.push_back(keywords[Tools::RandU<std::size_t>(89, 30)].get());
+        forms.push_back(std::move(form));
+    }
+
+    // what BuildFormTable fills at data load
+    Tools::FlatMap<std::uint32_t, std::uint32_t> formIndex;
+    std::vector<Row> formTable;
+    formIndex.Reserve(kForms);
+    for (const auto& form : forms) {
+        formIndex[form->formID] = static_cast<std::uint32_t>(formTable.size());
+        formTable.push_back({form.get(), OldMult(form.get()), 0.0f});
+    }
+
+    std::vector<const Form*> lookups(4096);
+    for (auto& f : lookups) f = forms[Tools::RandU<std::size_t>(kForms - 1)].get();
+
+    constexpr std::size_t kCalls = 10'000'000;
+    std::size_t i = 0;
+    float oldSum = 0, bitsSum = 0, tableSum = 0;
+    const double oldNs = Test::NsPerOp(kCalls, 1, [&]() { oldSum += OldMult(lookups[i++ & 4095]); });
+    i = 0;
+    const double bitsNs = Test::NsPerOp(kCalls, 1, [&]() {
+        DurabilityNG::KeywordBits bits = 0;
+        for (const auto* kw : lookups[i++ & 4095]->keywords) bits |= mults.Bit(kw->formID);
+        bitsSum += mults(bits);
+    });
+    i = 0;
+    const double tableNs = Test::NsPerOp(kCalls, 1, [&]() {
+        const auto* form = lookups[i++ & 4095];
+        const auto& row = formTable[*formIndex.Find(form->formID)];
+        tableSum += row.form == form ? row.mult : OldMult(form);
+    });
+    Test::Keep(oldSum);
+    Test::Keep(bitsSum);
+    Test::Keep(tableSum);
+    CHECK(std::abs(oldSum - tableSum) <= 1e-3 * oldSum);
+    CHECK(std::abs(oldSum - bitsSum) <= 1e-3 * oldSum);
+    std::printf("GetMult over %zu armor forms, ns per call: kw2mul + root %.1f, keyword bits + exp %.1f, form table %.1f\n",
+        kForms, oldNs, bitsNs, tableNs);
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "Materials.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+using namespace DurabilityNG;
+
+// GetMult before the keyword bitsets: one kw2mul probe per keyword, the
+// product of the materials and sqrt/cbrt/pow for their geometric mean
+struct OldMults {
+    std::unordered_map<std::uint32_t, float> kw2mul;
+    float noMaterialMult = 2.5;
+
+    float operator()(const std::vector<std::uint32_t>& keywords) const {
+        float oth = 1.0;
+        float mat = 1.0;
+        int materials = 0;
+        for (const auto kw : keywords) {
+            const auto val = kw2mul.find(kw);
+            if (val != kw2mul.cend()) {
+                if (val->second == 0.0) return 0.0;
+                if (val->second > 0.0) {
+                    materials++;
+                    mat *= val->second;
+                } else
+                    oth *= -val->second;
+            }
+        }
+        switch (materials) {
+            case 0: mat = noMaterialMult; break;
+            case 1: break;
+            case 2: mat = std::sqrt(mat); break;
+            case 3: mat = std::cbrt(mat); break;
+            default: mat = std::pow(mat, 1.0 / materials); break;
+        }
+        return mat * oth;
+    };
+};
+
+bool Close(float a, float b) {
+    return std::abs(a - b) <= 1e-5f * std::max(std::abs(a), std::abs(b));
+}
+
+int main() {
+    Tools::Seed(10);
+    OldMults old;
+    MaterialMults mults;
+    auto add = [&](std::uint32_t kw, float mult) {
+        old.kw2mul.try_emplace(kw, mult);
+        CHECK(mults.Add(kw, mult));
+    };
+    auto bits = [&](const std::vector<std::uint32_t>& keywords) {
+        KeywordBits b = 0;
+        for (const auto kw : keywords) b |= mults.Bit(kw);
+        return b;
+    };
+
+    // ids 1..40 materials, 41..55 factors (negative), 56..58 zero
+    for (std::uint32_t kw = 1; kw <= 40; kw++) add(kw, Tools::RandU<float>(4.0f, 0.25f));
+    for (std::uint32_t kw = 41; kw <= 55; kw++) add(kw, -Tools::RandU<float>(2.0f, 0.5f));
+    for (std::uint32_t kw = 56; kw <= 58; kw++) add(kw, 0.0f);
+    // the first value of a keyword wins, as with kw2mul.try_emplace
+    add(1, 100.0f);
+
+    // hand-picked cases: no keyword, unknown ones only, a zero, a factor
+    // alone, and 1 to 5 materials (each root of the old switch)
+    const std::vector<std::vector<std::uint32_t>> cases = {
+        {}, {100, 200}, {57}, {3, 57}, {44, 57, 9}, {42}, {42, 43},
+        {1}, {1, 2}, {1, 2, 3}, {1, 2, 3, 4}, {1, 2, 3, 4, 5},
+        {7, 45}, {7, 8, 45, 46, 300},
+    };
+    for (const auto& kws : cases) {
+        CHECK(Close(mults(bits(kws)), old(kws)));
+    }
+    CHECK(mults(bits({})) == 2.5f);
+    CHECK(mults(bits({2, 56})) == 0.0f);
+
+    mults.SetDefault(1.5f);
+    old.noMaterialMult = 1.5f;
+    CHECK(Close(mults(bits({42})), old({42})));
+
+    // random keyword sets, including unknown ids and repeats
+    for (int round = 0; round < 100'000; round++) {
+        std::vector<std::uint32_t> kws;
+        for (auto n = Tools::RandU<int>(8); n > 0; n--) {
+            const auto roll = Tools::RandU<int>(99);
+            if (roll < 50) kws.push_back(Tools::RandU<std::uint32_t>(40, 1));
+            else if (roll < 70) kws.push_back(Tools::RandU<std::uint32_t>(55, 41));
+            else if (roll < 72) kws.push_back(Tools::RandU<std::uint32_t>(58, 56));
+            else kws.push_back(Tools::RandU<std::uint32_t>(500, 100));
+        }
+        // a repeated keyword counts once in the bitset; old GetMult saw a
+        // form's keywords without repeats too
+        std::sort(kws.begin(), kws.end());
+        kws.erase(std::unique(kws.begin(), kws.end()), kws.end());
+        CHECK(Close(mults(bits(kws)), old(kws)));
+    }
+
+    // 64 bits at most; later keywords are refused and map to no bit
+    for (std::uint32_t kw = 59; kw <= 64; kw++) CHECK(mults.Add(kw, 1.0f));
+    CHECK(!mults.Add(65, 1.0f));
+    CHECK(mults.Bit(65) == 0);
+    CHECK(mults.Bit(64) == KeywordBits(1) << 63);
+    std::printf("MaterialMults: matches the old geometric mean\n");
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include "Pick.h"
+#include "Check.h"
+
+#include <vector>
+
+using namespace DurabilityNG;
+
+// Build a list of n weighted items and pull k of them, as DestroyItems does
+// for NPC inventories (n ~ 20), the player (~100) and hoarders (10,000).
+template <class Policy>
+double Bench(std::size_t n, std::size_t k, std::size_t calls) {
+    std::vector<float> weights(n);
+    for (auto& w : weights) w = Tools::RandU<float>(10.0f, 0.1f);
+    return Test::NsPerOp(calls, 1, [&]() {
+        PickList<std::size_t, float, Policy> pick(static_cast<unsigned>(n));
+        for (std::size_t i = 0; i < n; i++) pick.Push(std::move(i), weights[i]);
+        for (std::size_t i = 0; i < k; i++) Test::Keep(pick.Pull());
+    });
+}
+
+int main() {
+    Tools::Seed(1);
+    for (const std::size_t n : {20, 100, 10'000}) {
+        const std::size_t calls = 400'000 / n;
+        for (const std::size_t k : {std::size_t(10), n}) {
+            const double lin = Bench<LinearPick>(n, k, calls);
+            const double fen = Bench<FenwickPick>(n, k, calls);
+            std::printf("PickList n=%5zu, %5zu pulls: linear %9.0f ns, Fenwick %9.0f ns\n", n, k, lin, fen);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include "Pick.h"
+#include "Check.h"
+
+#include <array>
+#include <vector>
+
+using namespace DurabilityNG;
+
+// First and second pulls of weighted sampling without replacement, for both
+// weight storages, against the exact probabilities.
+template <class Policy>
+void CheckPulls() {
+    constexpr std::array<float, 6> weights{1, 2, 3, 4, 0.5f, 9.5f};
+    constexpr int kTrials = 200'000;
+    double total = 0;
+    for (auto w : weights) total += w;
+
+    std::array<double, weights.size()> first{}, second{};
+    for (int t = 0; t < kTrials; t++) {
+        PickList<int, float, Policy> pick(weights.size());
+        for (int i = 0; i < int(weights.size()); i++) pick.Push(std::move(i), weights[i]);
+        const int a = *pick.Pull();
+        const int b = *pick.Pull();
+        CHECK(a != b);
+        first[a]++;
+        second[b]++;
+    }
+
+    std::array<double, weights.size()> expFirst{}, expSecond{};
+    for (std::size_t i = 0; i < weights.size(); i++) {
+        expFirst[i] = kTrials * weights[i] / total;
+        for (std::size_t j = 0; j < weights.size(); j++)
+            if (j != i) expSecond[i] += kTrials * weights[j] / total * weights[i] / (total - weights[j]);
+    }
+    const double crit = Test::ChiSquareCritical(weights.size() - 1);
+    CHECK(Test::ChiSquare(first, expFirst) < crit);
+    CHECK(Test::ChiSquare(second, expSecond) < crit);
+
+    // exhausting the list returns every entry once, then nothing
+    PickList<int, float, Policy> pick(weights.size());
+    for (int i = 0; i < int(weights.size()); i++) pick.Push(std::move(i), weights[i]);
+    pick.Push(99, 0.0f); // zero weights are never stored
+    std::array<int, weights.size()> seen{};
+    float w;
+    for (std::size_t i = 0; i < weights.size(); i++) {
+        auto item = pick.Pull(&w);
+        CHECK(item);
+        CHECK(w == weights[*item]);
+        seen[*item]++;
+    }
+    CHECK(!pick.Pull());
+    for (auto n : seen) CHECK(n == 1);
+
+    // Update puts a pulled entry back with a new weight
+    PickList<int, float, Policy> upd(2);
+    upd.Push(0, 1.0f);
+    upd.Push(1, 1.0f);
+    auto item = upd.Pull();
+    upd.Update(item, 3.0f);
+    CHECK(std::abs(upd.weightSum() - 4.0) < 1e-9);
+}
+
+int main() {
+    Tools::Seed(12345);
+    CheckPulls<LinearPick>();
+    CheckPulls<FenwickPick>();
+    std::puts("PickList: linear and Fenwick pulls match the exact distribution");
+    return 0;
+}
@@ -0,0 +1,46 @@
+#include "Pick.h"
+#include "Check.h"
+
+#include <vector>
+
+using namespace DurabilityNG;
+
+// engine steps taken since `before`, by stepping a copy until both agree
+std::size_t Draws(Tools::Engine before) {
+    for (std::size_t k = 0; k < 1000; k++) {
+        auto a = before, b = Tools::ThreadEngine();
+        if (a() == b()) return k;
+        before();
+    }
+    return ~std::size_t(0);
+}
+
+template <class Pick>
+void Bench(const char* name, std::size_t n, const std::vector<float>& weights) {
+    const auto before = Tools::ThreadEngine();
+    {
+        Pick pick;
+        for (std::size_t i = 0; i < n; i++) pick.Push(int(i), weights[i]);
+        Test::Keep(pick.Get(-1));
+    }
+    const auto draws = Draws(before);
+    const double ns = Test::NsPerOp(1'000'000, 1, [&]() {
+        Pick pick;
+        for (std::size_t i = 0; i < n; i++) pick.Push(int(i), weights[i]);
+        Test::Keep(pick.Get(-1));
+    });
+    std::printf("%-13s %2zu candidates: %2zu RNG draws, %6.1f ns per pick\n", name, n, draws, ns);
+}
+
+// The defense stage picks one of the equipped items per hit. PickOne draws
+// once per candidate, PickOnePrefix once per pick.
+int main() {
+    Tools::Seed(3);
+    std::vector<float> weights(32);
+    for (auto& w : weights) w = Tools::RandU<float>(4.0f, 0.5f);
+    for (const std::size_t n : {4, 8, 16, 32}) {
+        Bench<PickOne<int>>("PickOne", n, weights);
+        Bench<PickOnePrefix<int>>("PickOnePrefix", n, weights);
+    }
+    return 0;
+}
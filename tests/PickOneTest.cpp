@@ -0,0 +1,44 @@
+#include "Pick.h"
+#include "Check.h"
+
+#include <array>
+
+using namespace DurabilityNG;
+
+// winner distribution of PickOnePrefix, within N candidates and past N, where
+// the last slot turns into a reservoir
+template <std::size_t N, std::size_t K>
+void CheckDistribution() {
+    constexpr int kTrials = 200'000;
+    std::array<float, K> weights;
+    double total = 0;
+    for (std::size_t i = 0; i < K; i++) total += weights[i] = 0.5f + (i * 7 % 5);
+
+    std::array<double, K> seen{}, expected{};
+    for (int t = 0; t < kTrials; t++) {
+        PickOnePrefix<int, N> pick;
+        for (std::size_t i = 0; i < K; i++) pick.Push(int(i), weights[i]);
+        seen[pick.Get(-1)]++;
+    }
+    for (std::size_t i = 0; i < K; i++) expected[i] = kTrials * weights[i] / total;
+    CHECK(Test::ChiSquare(seen, expected) < Test::ChiSquareCritical(K - 1));
+}
+
+int main() {
+    Tools::Seed(778);
+    CheckDistribution<32, 5>();
+    CheckDistribution<32, 32>();
+    CheckDistribution<8, 20>();
+
+    PickOnePrefix<int> empty;
+    CHECK(!empty.Has());
+    CHECK(empty.Get(-1) == -1);
+
+    // the winner is drawn once and stays until the next Push
+    PickOnePrefix<int> pick;
+    for (int i = 0; i < 10; i++) pick.Push(i, 1.0f);
+    const int first = pick.Get(-1);
+    for (int i = 0; i < 10; i++) CHECK(pick.Get(-1) == first);
+    std::puts("PickOnePrefix: winner distribution ok");
+    return 0;
+}
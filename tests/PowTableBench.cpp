@@ -0,0 +1,27 @@
+#include "PowTable.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <vector>
+
+using namespace DurabilityNG;
+
+// the break stage evaluates pow(cur, Break.ExponentLow) once per degrade
+int main() {
+    constexpr std::size_t kCalls = 20'000'000;
+    Tools::Seed(42);
+    std::vector<float> health(4096);
+    for (auto& h : health) h = Tools::RandU<float>(1.0f, 0.01f);
+
+    PowTable table;
+    table.Build(0.01f, 1.0f, -0.5f);
+    const float exponent = -0.5f;
+    float sum = 0;
+    std::size_t i = 0;
+    const double powNs = Test::NsPerOp(kCalls, 1, [&]() { sum += std::pow(health[i++ & 4095], exponent); });
+    const double tableNs = Test::NsPerOp(kCalls, 1, [&]() { sum += table(health[i++ & 4095]); });
+    Test::Keep(sum);
+    CHECK(std::isfinite(sum));
+    std::printf("pow(cur, -0.5): std::pow %.2f ns, PowTable %.2f ns, max relative error %.2e\n", powNs, tableNs, table.MaxError());
+    return 0;
+}
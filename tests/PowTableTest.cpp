@@ -0,0 +1,41 @@
+#include "PowTable.h"
+#include "Check.h"
+
+using namespace DurabilityNG;
+
+// relative error of the table against pow over a dense grid, and the
+// interpolation bound h^2/8 * |e(e-1)| / x^2 at the worst point
+void Check(float lo, float hi, float exponent) {
+    PowTable table;
+    table.Build(lo, hi, exponent);
+    const double h = (double(hi) - lo) / 1024;
+    const double bound = h * h / 8 * std::abs(exponent * (exponent - 1.0)) / (double(lo) * lo);
+    double worst = 0;
+    for (int i = 0; i <= 100'000; i++) {
+        const float x = lo + (hi - lo) * (i / 100'000.0f);
+        const double exact = std::pow(double(x), double(exponent));
+        worst = std::max(worst, std::abs(table(x) - exact) / exact);
+    }
+    // float rounding of x and of the table adds a few ulps on top
+    CHECK(worst <= bound + 1e-6);
+    CHECK(table.MaxError() <= worst + 1e-6);
+    CHECK(table.MaxError() >= worst * 0.5);
+    std::printf("pow(x, %5.2f) on [%.2f, %.1f]: max relative error %.2e, bound %.2e\n", exponent, lo, hi, worst, bound);
+
+    // outside the range it is pow
+    for (float x : {lo * 0.5f, hi, hi * 2.0f})
+        CHECK(table(x) == std::pow(x, exponent));
+}
+
+int main() {
+    for (float e : {-0.5f, -1.0f, -2.0f, 0.5f, 2.0f}) {
+        Check(0.01f, 1.0f, e);
+        Check(1.0f, 4.0f, e);
+    }
+
+    // the default Break.ExponentLow stays below 0.1%
+    PowTable table;
+    table.Build(0.01f, 1.0f, -0.5f);
+    CHECK(table.MaxError() < 1e-3);
+    return 0;
+}
@@ -0,0 +1,31 @@
+#include "Tools.h"
+#include "Check.h"
+
+#include <random>
+
+// RandU as it was before xoshiro256++: mt19937_64 and a distribution
+// constructed per call
+template <class T>
+T RandMt(T max = 1, T min = 0) {
+    thread_local std::mt19937_64 mt{42};
+    if constexpr (std::is_floating_point_v<T>)
+        return std::uniform_real_distribution<T>(min, max)(mt);
+    else
+        return std::uniform_int_distribution<T>(min, max)(mt);
+}
+
+int main() {
+    constexpr std::size_t kCalls = 20'000'000;
+    Tools::Seed(42);
+    float fsum = 0;
+    int isum = 0;
+    const double mtFloat = Test::NsPerOp(kCalls, 1, [&]() { fsum += RandMt<float>(10.0f); });
+    const double xoFloat = Test::NsPerOp(kCalls, 1, [&]() { fsum += Tools::RandU<float>(10.0f); });
+    const double mtInt = Test::NsPerOp(kCalls, 1, [&]() { isum += RandMt<int>(37); });
+    const double xoInt = Test::NsPerOp(kCalls, 1, [&]() { isum += Tools::RandU<int>(37); });
+    Test::Keep(fsum);
+    Test::Keep(isum);
+    std::printf("RandU<float>: mt19937_64 %.2f ns, xoshiro256++ %.2f ns\n", mtFloat, xoFloat);
+    std::printf("RandU<int>:   mt19937_64 %.2f ns, xoshiro256++ %.2f ns\n", mtInt, xoInt);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "Tools.h"
+#include "Check.h"
+
+#include <array>
+#include <thread>
+
+int main() {
+    // Seed makes the calling thread reproducible
+    Tools::Seed(42);
+    std::array<std::uint64_t, 8> a, b;
+    for (auto& v : a) v = Tools::RandU<std::uint64_t>(~0ull);
+    Tools::Seed(42);
+    for (auto& v : b) v = Tools::RandU<std::uint64_t>(~0ull);
+    CHECK(a == b);
+
+    // threads created after Seed get their own, different streams
+    std::uint64_t t1 = 0, t2 = 0;
+    std::thread([&]() { t1 = Tools::ThreadEngine()(); }).join();
+    std::thread([&]() { t2 = Tools::ThreadEngine()(); }).join();
+    CHECK(t1 != t2);
+
+    // ranges: integers in [min, max], floats in [min, max)
+    std::array<double, 6> counts{};
+    for (int i = 0; i < 600'000; i++) {
+        const int d = Tools::RandU<int>(8, 3);
+        CHECK(d >= 3 && d <= 8);
+        counts[d - 3]++;
+        const float f = Tools::RandU<float>(2.0f, -1.0f);
+        CHECK(f >= -1.0f && f < 2.0f);
+        const double x = Tools::RandU<double>();
+        CHECK(x >= 0.0 && x < 1.0);
+    }
+    std::array<double, 6> expected;
+    expected.fill(100'000);
+    CHECK(Test::ChiSquare(counts, expected) < Test::ChiSquareCritical(5));
+    CHECK(Tools::RandU<int>(5, 5) == 5);
+    CHECK(Tools::RandU<float>(0.0f) == 0.0f);
+
+    // float buckets are uniform too
+    std::array<double, 16> buckets{};
+    for (int i = 0; i < 320'000; i++) buckets[static_cast<int>(Tools::RandU<float>(16.0f))]++;
+    std::array<double, 16> flat;
+    flat.fill(20'000);
+    CHECK(Test::ChiSquare(buckets, flat) < Test::ChiSquareCritical(15));
+
+    std::puts("RandU: ranges, uniformity and seeding ok");
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "RingBuffer.h"
+#include "Check.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// same size as the HitRecord the hit sink enqueues
+struct Record {
+    std::uint32_t cause, target, source, projectile;
+    std::uint8_t flags;
+};
+
+int main() {
+    constexpr std::size_t kCapacity = 4096;
+    constexpr std::size_t kRounds = 2500; // ~10M events
+    static Tools::RingBuffer<Record, kCapacity> queue;
+
+    std::uint64_t sum = 0;
+    double pushNs = 0, popNs = 0;
+    for (std::size_t r = 0; r < kRounds; r++) {
+        // enqueue a full frame's worth, then drain it like HitEventHandler::Drain
+        pushNs += Test::NsPerOp(1, kCapacity, [&]() {
+            for (std::uint32_t i = 0; i < kCapacity; i++)
+                CHECK(queue.TryPush({i, i + 1, 0x12EB7, 0, 1}));
+        });
+        popNs += Test::NsPerOp(1, kCapacity, [&]() {
+            Record rec;
+            while (queue.TryPop(rec)) sum += rec.cause;
+        });
+    }
+    CHECK(sum == kRounds * (kCapacity * (kCapacity - 1) / 2));
+    std::printf("RingBuffer: %zu events, enqueue %.2f ns, dequeue %.2f ns\n",
+        kRounds * kCapacity, pushNs / kRounds, popNs / kRounds);
+
+    // contended: producers push while the consumer drains
+    for (const int producers : {1, 2, 4}) {
+        constexpr std::size_t kEvents = 4'000'000;
+        std::atomic<bool> go{false};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++)
+            threads.emplace_back([&]() {
+                while (!go.load()) std::this_thread::yield();
+                for (std::size_t i = 0; i < kEvents / producers; i++)
+                    while (!queue.TryPush({std::uint32_t(i), 0, 0, 0, 0})) std::this_thread::yield();
+            });
+        std::size_t popped = 0;
+        const double ns = Test::NsPerOp(1, kEvents, [&]() {
+            go.store(true);
+            Record rec;
+            while (popped < kEvents / producers * producers)
+                if (queue.TryPop(rec)) popped++;
+                else std::this_thread::yield();
+        });
+        for (auto& t : threads) t.join();
+        std::printf("RingBuffer: %d producer(s), %.2f ns per event end to end\n", producers, ns);
+    }
+    return 0;
+}
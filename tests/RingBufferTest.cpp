@@ -0,0 +1,52 @@
+#include "RingBuffer.h"
+#include "Check.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Several producers push tagged sequence numbers while one consumer drains,
+// as the hit sinks and the per-frame drain do. Every value must arrive once
+// and each producer's values in order.
+int main() {
+    constexpr std::uint64_t kProducers = 4;
+    constexpr std::uint64_t kPerProducer = 1'000'000;
+    Tools::RingBuffer<std::uint64_t, 4096> queue;
+
+    // single-threaded basics
+    std::uint64_t v;
+    CHECK(!queue.TryPop(v));
+    for (std::uint64_t i = 0; i < queue.Capacity(); i++) CHECK(queue.TryPush(i));
+    CHECK(!queue.TryPush(0));
+    CHECK(queue.Size() == queue.Capacity());
+    for (std::uint64_t i = 0; i < queue.Capacity(); i++) {
+        CHECK(queue.TryPop(v));
+        CHECK(v == i);
+    }
+    CHECK(!queue.TryPop(v));
+
+    std::vector<std::thread> producers;
+    for (std::uint64_t p = 0; p < kProducers; p++)
+        producers.emplace_back([&queue, p]() {
+            for (std::uint64_t i = 0; i < kPerProducer; i++)
+                while (!queue.TryPush(p << 32 | i)) std::this_thread::yield();
+        });
+
+    std::vector<std::uint64_t> next(kProducers, 0);
+    for (std::uint64_t n = 0; n < kProducers * kPerProducer;) {
+        if (!queue.TryPop(v)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto p = v >> 32;
+        CHECK(p < kProducers);
+        CHECK((v & 0xFFFFFFFF) == next[p]);
+        next[p]++;
+        n++;
+    }
+    for (auto& t : producers) t.join();
+    for (const auto n : next) CHECK(n == kPerProducer);
+    CHECK(!queue.TryPop(v));
+    std::puts("RingBuffer: multi-producer order and delivery ok");
+    return 0;
+}
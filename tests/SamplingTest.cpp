@@ -0,0 +1,87 @@
+#include "Sampling.h"
+#include "Check.h"
+
+#include <algorithm>
+
+using namespace DurabilityNG;
+
+// A stream of NPC-vs-NPC hits, processed in full and through [Subsample]
+// with fraction p. Subsampled hits carry 1/p as their count; wear, destroy
+// rolls and the break chance of an item have to come out the same.
+struct Totals {
+    double wear = 0;
+    double rolls = 0;
+    double survived = 0; // items still intact after each fight
+};
+
+Totals Fight(std::size_t fights, std::size_t hitsPerFight, float p, float info, float destroy, float survival) {
+    Totals t;
+    for (std::size_t f = 0; f < fights; f++) {
+        bool intact = true;
+        for (std::size_t i = 0; i < hitsPerFight; i++) {
+            const float hits = SubsampleWeight(p);
+            if (!hits) continue;
+            t.wear += info * hits;
+            t.rolls += DestroyRolls(destroy, hits);
+            // Degrade: the item has to survive every hit this one stands for
+            if (intact && std::pow(survival, hits) <= Tools::RandU<float>()) intact = false;
+        }
+        t.survived += intact;
+    }
+    return t;
+}
+
+int main() {
+    Tools::Seed(20);
+
+    // the mean of Rolls is its argument, also above 1
+    for (float expected : {0.0f, 0.05f, 0.5f, 1.0f, 2.7f, 10.0f}) {
+        constexpr int kDraws = 200'000;
+        double sum = 0;
+        for (int i = 0; i < kDraws; i++) {
+            const auto n = Rolls(expected);
+            CHECK(n == std::floor(expected) || n == std::floor(expected) + 1);
+            sum += n;
+        }
+        CHECK(std::abs(sum / kDraws - expected) <= 0.01 * std::max(expected, 1.0f));
+    }
+
+    // a single hit rolls at most once, however large its chance: a power
+    // attack (x3) under Destroy Global 0.5 stays at one roll
+    for (float info : {1.0f, 1.5f, 3.0f, 40.0f}) {
+        for (int i = 0; i < 1000; i++) CHECK(DestroyRolls(info, 1.0f) == 1);
+    }
+    // and one standing for several hits rolls at most that many times
+    for (int i = 0; i < 1000; i++) {
+        CHECK(DestroyRolls(1.5f, 10.0f) == 10);
+        CHECK(DestroyRolls(1.5f, 2.5f) >= 2 && DestroyRolls(1.5f, 2.5f) <= 3);
+    }
+
+    constexpr std::size_t kFights = 20'000, kHits = 30;
+    for (float p : {0.5f, 0.1f}) {
+        for (float destroy : {0.05f, 0.3f, 0.8f, 1.5f}) {
+            const auto full = Fight(kFights, kHits, 1.0f, 0.02f, destroy, 0.99f);
+            const auto sub = Fight(kFights, kHits, p, 0.02f, destroy, 0.99f);
+            std::printf("p %.1f destroy %.2f: wear %.4f/%.4f, rolls %.4f/%.4f, intact %.3f/%.3f\n", p, destroy,
+                full.wear / kFights, sub.wear / kFights, full.rolls / kFights, sub.rolls / kFights,
+                full.survived / kFights, sub.survived / kFights);
+            CHECK(std::abs(sub.wear / full.wear - 1.0) < 0.03);
+            CHECK(std::abs(sub.rolls / full.rolls - 1.0) < 0.05);
+            // pow(s, 1/p) on a kept hit leaves a small Jensen gap, well
+            // below the effect of dropping the hits altogether
+            CHECK(std::abs(sub.survived - full.survived) / kFights < 0.03);
+        }
+    }
+
+    // the single clamped roll this replaces loses most destroy rolls at p 0.1
+    double clamped = 0, rolls = 0;
+    for (int i = 0; i < 100'000; i++) {
+        const float hits = SubsampleWeight(0.1f);
+        if (!hits) continue;
+        const float info = 0.3f * hits;
+        clamped += info >= 1.0f || info > Tools::RandU<float>();
+        rolls += DestroyRolls(0.3f, hits);
+    }
+    CHECK(clamped < 0.5 * rolls);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include "ShadowStore.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <array>
+#include <memory>
+
+DurabilityNG::Stats* DurabilityNG::Stats::GetSingleton() {
+    static Stats singleton;
+    return std::addressof(singleton);
+}
+
+using namespace DurabilityNG;
+
+// below 1.0, since crossing it is always written through
+struct Extra {
+    float health = 0.9f;
+};
+using Store = ShadowStore<Extra>;
+
+constexpr std::uint32_t kActor = 0x14;
+constexpr float kStep = 0.05f;
+constexpr float kMinHealth = 0.01f;
+
+// the shadow part of Settings::Degrade
+void Degrade(Store& store, std::uint32_t form, Extra* extra, float wear) {
+    auto& shadow = store.Get(kActor, form, false, extra);
+    const float cur = std::max(kMinHealth, shadow.health - wear);
+    shadow.health = cur;
+    if (!store.Due(shadow, kStep, kMinHealth)) return;
+    shadow.written = cur;
+    extra->health = cur;
+}
+
+// ShadowHealth::Sync: write to whichever list of the entry holds the
+// instance, then forget the shadow
+template <std::size_t N>
+void Sync(Store& store, std::uint32_t form, const std::array<Extra*, N>& lists) {
+    if (auto* shadow = store.Find(kActor, form, false)) {
+        for (auto* extra : lists)
+            if (store.Owns(*shadow, extra)) {
+                store.Write(*shadow, extra);
+                break;
+            }
+        store.Erase(kActor, form, false);
+    }
+}
+
+int main() {
+    Tools::Seed(22);
+
+    // absorbed until the step, then written through
+    {
+        Store store;
+        Extra extra;
+        Degrade(store, 1, &extra, 0.02f);
+        CHECK(extra.health == 0.9f);
+        CHECK(store.Find(kActor, 1, false)->health == 0.88f);
+        Degrade(store, 1, &extra, 0.02f);
+        Degrade(store, 1, &extra, 0.02f);
+        CHECK(extra.health == store.Find(kActor, 1, false)->health);
+        CHECK(extra.health < 0.85f);
+    }
+
+    // the engine changed the health (repair, temper): the shadow follows it
+    // and is not written back over it
+    {
+        Store store;
+        Extra extra;
+        Degrade(store, 1, &extra, 0.02f);
+        extra.health = 0.7f;
+        std::array lists{&extra};
+        Sync(store, 1, lists);
+        CHECK(extra.health == 0.7f);
+        Degrade(store, 1, &extra, 0.02f);
+        CHECK(store.Find(kActor, 1, false)->health == 0.7f - 0.02f);
+    }
+
+    // another instance of the same form: a fresh shadow, the old one unwritten
+    {
+        Store store;
+        Extra a, b;
+        Degrade(store, 1, &a, 0.02f);
+        Degrade(store, 1, &b, 0.01f);
+        CHECK(store.Find(kActor, 1, false)->extra == &b);
+        CHECK(store.Find(kActor, 1, false)->health == 0.9f - 0.01f);
+    }
+
+    // restored from the co-save: 16-bit values and no Extra pointer, and the
+    // first sync after loading has to write it, not drop it
+    {
+        Store store;
+        Extra other, extra;
+        other.health = 0.5f;
+        extra.health = 0.8f + Store::kQuantum / 3; // as saved, off by rounding
+        store.Restore(kActor, 1, false, 0.75f, 0.8f);
+        std::array lists{&other, &extra};
+        Sync(store, 1, lists);
+        CHECK(extra.health == 0.75f);
+        CHECK(other.health == 0.5f);
+        CHECK(!store.Find(kActor, 1, false));
+
+        // a restored shadow whose instance the engine changed meanwhile
+        extra.health = 0.9f;
+        store.Restore(kActor, 1, false, 0.75f, 0.8f);
+        Sync(store, 1, lists);
+        CHECK(extra.health == 0.9f);
+    }
+
+    // random degrades, engine edits and syncs against a model of the health
+    // every degrade would have written
+    {
+        Store store;
+        std::array<Extra, 4> extras;
+        std::array<float, 4> model{0.9f, 0.9f, 0.9f, 0.9f};
+        for (int step = 0; step < 200'000; step++) {
+            const auto i = Tools::RandU<std::uint32_t>(3);
+            auto* extra = &extras[i];
+            const auto op = Tools::RandU<int>(99);
+            if (op < 70) {
+                const float wear = Tools::RandU<float>(0.02f);
+                Degrade(store, i + 1, extra, wear);
+                model[i] = std::max(kMinHealth, model[i] - wear);
+                CHECK(store.Find(kActor, i + 1, false)->health == model[i]);
+                CHECK(std::abs(extra->health - model[i]) < kStep);
+            } else if (op < 75) {
+                extra->health = model[i] = Tools::RandU<float>(1.5f, 0.5f);
+            } else {
+                std::array lists{&extras[(i + 1) % 4], extra};
+                Sync(store, i + 1, lists);
+                CHECK(extra->health == model[i]);
+                CHECK(!store.Find(kActor, i + 1, false));
+            }
+        }
+    }
+
+    const auto* stats = Stats::GetSingleton();
+    CHECK(stats->shadowWrites.load() > 0);
+    CHECK(stats->shadowResyncs.load() > 0);
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "Throttle.h"
+#include "Sampling.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <memory>
+#include <vector>
+
+DurabilityNG::Stats* DurabilityNG::Stats::GetSingleton() {
+    static Stats singleton;
+    return std::addressof(singleton);
+}
+
+using namespace DurabilityNG;
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+struct Closed {
+    std::uint32_t attacker;
+    int swing;
+    float wear, hits;
+};
+
+int main() {
+    Tools::Seed(24);
+    const auto t0 = Clock::time_point{} + std::chrono::hours(1);
+    const auto window = milliseconds(50);
+    std::vector<Closed> closed;
+    auto close = [&](std::uint32_t attacker, int swing, float wear, float hits) {
+        closed.push_back({attacker, swing, wear, hits});
+    };
+
+    // a sweep hitting three targets is one degrade of 1 + 2 * factor, and
+    // the extra hits count for the break check
+    {
+        SwingFilter<int> swings;
+        swings.Hit(0x14, 0x1, 7, 1.0f, 0.5f, t0, window, close);
+        swings.Hit(0x14, 0x1, 7, 1.0f, 0.5f, t0 + milliseconds(5), window, close);
+        swings.Hit(0x14, 0x1, 7, 1.0f, 0.5f, t0 + milliseconds(10), window, close);
+        CHECK(closed.empty());
+        swings.Expire(t0 + milliseconds(49), window, close);
+        CHECK(closed.empty());
+        swings.Expire(t0 + milliseconds(50), window, close);
+        CHECK(closed.size() == 1);
+        CHECK(closed[0].attacker == 0x14 && closed[0].swing == 7);
+        CHECK(closed[0].wear == 2.0f && closed[0].hits == 3.0f);
+        CHECK(!swings.Open());
+        closed.clear();
+    }
+
+    // the next swing closes the last one without waiting for the sweep
+    {
+        SwingFilter<int> swings;
+        swings.Hit(0x14, 0x1, 1, 1.0f, 0.5f, t0, window, close);
+        swings.Hit(0x14, 0x1, 2, 1.0f, 0.5f, t0 + milliseconds(60), window, close);
+        CHECK(closed.size() == 1 && closed[0].swing == 1 && closed[0].wear == 1.0f);
+        CHECK(swings.Open() == 1);
+        swings.Clear();
+        swings.Expire(t0 + milliseconds(200), window, close);
+        CHECK(closed.size() == 1); // a revert drops open windows
+        closed.clear();
+    }
+
+    // many attackers share 256 slots: collisions close windows early, but
+    // every hit ends up in exactly one close and the wear adds up
+    {
+        SwingFilter<int> swings;
+        double hitsIn = 0, wearMin = 0;
+        auto now = t0;
+        for (int i = 0; i < 100'000; i++) {
+            now += std::chrono::microseconds(Tools::RandU<int>(2000));
+            const auto attacker = 0xFF000000u + Tools::RandU<std::uint32_t>(60);
+            const auto source = 0x100u + Tools::RandU<std::uint32_t>(3);
+            const float hits = Tools::RandU<int>(3) ? 1.0f : 2.5f; // subsampled
+            swings.Hit(attacker, source, int(source), hits, 0.25f, now, window, close);
+            hitsIn += hits;
+            wearMin += 0.25f * hits;
+            if (i % 16 == 0) swings.Expire(now, window, close);
+        }
+        swings.Expire(now + window, window, close);
+        CHECK(!swings.Open());
+        double hitsOut = 0, wearOut = 0;
+        for (const auto& c : closed) {
+            hitsOut += c.hits;
+            wearOut += c.wear;
+            CHECK(c.wear <= c.hits && c.wear >= 0.25f * c.hits);
+        }
+        CHECK(std::abs(hitsOut - hitsIn) < 1e-6 * hitsIn);
+        CHECK(wearOut > wearMin && wearOut < hitsIn);
+        std::printf("SwingFilter: %zu windows for %.0f hits\n", closed.size(), hitsIn);
+    }
+
+    // HitRate 10, HitBurst 10 against 1,000 hits/s on one defender for 10 s,
+    // destroy info 0.05 per hit: about 110 hits get through, each standing
+    // for the ones skipped before it, and destroy still rolls 50 times/s
+    {
+        HitLimiter limiter;
+        constexpr int kHits = 10'000;
+        constexpr float kInfo = 0.05f;
+        double passed = 0, folded = 0, expected = 0, rolls = 0, clamped = 0;
+        for (int i = 0; i < kHits; i++) {
+            const float hits = limiter.Take(0xFF000800, 1.0f, t0 + milliseconds(i), 10.0f, 10.0f);
+            if (!hits) continue;
+            passed++;
+            folded += hits;
+            expected += kInfo * hits;
+            rolls += DestroyRolls(kInfo, hits);
+            clamped += kInfo * hits >= 1.0f || kInfo * hits > Tools::RandU<float>();
+        }
+        // the skipped hits after the last one that got through are pending
+        const float rest = limiter.Take(0xFF000800, 0.0f, t0 + std::chrono::hours(2), 10.0f, 10.0f);
+        std::printf("HitLimiter: %.0f of %d hits processed, %.1f destroy rolls/s (%.1f expected, %.1f with one roll per hit)\n",
+            passed, kHits, rolls / 10, expected / 10, clamped / 10);
+        CHECK(passed >= 105 && passed <= 115);
+        CHECK(std::abs(folded + rest - kHits) < 1e-3);
+        CHECK(std::abs(expected / 10 - 50.0) < 0.5);
+        CHECK(std::abs(rolls / 10 - 50.0) < 7.5); // about 3 standard deviations
+        CHECK(clamped < 0.5 * rolls);
+    }
+
+    // below the rate every hit passes alone and a power attack with destroy
+    // info 1.5 still rolls exactly once, as without the limiter
+    {
+        HitLimiter limiter;
+        for (int i = 0; i < 100; i++) {
+            const float hits = limiter.Take(0xFF000900, 1.0f, t0 + milliseconds(200 * i), 10.0f, 10.0f);
+            CHECK(hits == 1.0f);
+            CHECK(DestroyRolls(1.5f, hits) == 1);
+        }
+    }
+
+    // every defender ever hit used to keep its bucket; idle, full ones go
+    {
+        HitLimiter limiter;
+        for (std::uint32_t d = 0; d < 5000; d++)
+            limiter.Take(0xFF000000 + d, 1.0f, t0 + milliseconds(d), 10.0f, 10.0f);
+        CHECK(limiter.Size() < 600);
+        // a throttled defender keeps its skipped hits through pruning
+        for (int i = 0; i < 20; i++) limiter.Take(0x14, 1.0f, t0, 10.0f, 10.0f);
+        for (std::uint32_t d = 0; d < 5000; d++)
+            limiter.Take(0xFF100000 + d, 1.0f, t0 + milliseconds(d), 10.0f, 10.0f);
+        CHECK(limiter.Take(0x14, 1.0f, t0 + milliseconds(5000), 10.0f, 10.0f) == 11.0f);
+        limiter.Clear();
+        CHECK(limiter.Size() == 0);
+    }
+    return 0;
+}
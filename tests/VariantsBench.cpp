@@ -0,0 +1,115 @@
+#include "Group.h"
+#include "Tools.h"
+#include "Check.h"
+
+#include <array>
+#include <utility>
+#include <vector>
+
+using namespace DurabilityNG;
+
+// HitEventHandler::Process with the stage bodies stubbed out, to time what
+// the specialization saves per hit: the ActorInfo lookups and branches of
+// disabled stages, against one indirect call through the Variants table.
+// The real stages do far more work once enabled; that part is the same on
+// both sides and left out. Process is far too large to be inlined into
+// ProcessEvent, so both sides are called out of line here.
+struct Hit {
+    ActorTraits traits;
+    std::uint8_t flags;
+};
+
+struct Groups {
+    Group Attack, Defense, Destroy;
+    unsigned destroyMessage = 100;
+} settings;
+
+float sink = 0;
+
+inline void Stage(float info) { sink += info; }
+
+// before: every stage looked up its ActorInfo on every hit
+void ProcessRuntime(const Hit& hit) {
+    if (const auto info = settings.Attack.ActorInfo(hit.traits, hit.flags)) Stage(info);
+    if (const auto info = settings.Defense.ActorInfo(hit.traits, hit.flags)) Stage(info);
+    if (const auto info = settings.Destroy.ActorInfo(hit.traits, hit.flags)) {
+        Stage(info);
+        if (settings.destroyMessage) Stage(1.0f);
+    }
+}
+
+template <bool Attack, bool Defense, bool Destroy, bool Message>
+void Process(const Hit& hit) {
+    if constexpr (Attack)
+        if (const auto info = settings.Attack.ActorInfo(hit.traits, hit.flags)) Stage(info);
+    if constexpr (Defense)
+        if (const auto info = settings.Defense.ActorInfo(hit.traits, hit.flags)) Stage(info);
+    if constexpr (Destroy)
+        if (const auto info = settings.Destroy.ActorInfo(hit.traits, hit.flags)) {
+            Stage(info);
+            if constexpr (Message) Stage(1.0f);
+        }
+}
+
+using ProcessFn = void (*)(const Hit&);
+
+template <std::size_t... I>
+constexpr std::array<ProcessFn, sizeof...(I)> Variants(std::index_sequence<I...>) {
+    return {&Process<!!(I & 1), !!(I & 2), !!(I & 4), !!(I & 8)>...};
+}
+
+ProcessFn Select() {
+    const std::size_t i =
+        (settings.Attack.Enabled()  ? 1 : 0) |
+        (settings.Defense.Enabled() ? 2 : 0) |
+        (settings.Destroy.Enabled() ? 4 : 0) |
+        (settings.destroyMessage    ? 8 : 0);
+    if (!(i & 7)) return nullptr;
+    return Variants(std::make_index_sequence<16>{})[i];
+}
+
+void Configure(float attack, float defense, float destroy) {
+    for (auto [group, global] : {std::pair{&settings.Attack, attack}, {&settings.Defense, defense}, {&settings.Destroy, destroy}}) {
+        CSimpleIniA ini;
+        ini.SetDoubleValue("Group", "Global", global);
+        group->Load(ini, "Group");
+    }
+}
+
+int main() {
+    Tools::Seed(17);
+    std::vector<Hit> hits(4096);
+    for (auto& h : hits)
+        h = {Tools::RandU<ActorTraits>((1 << kTraitBits) - 1), Tools::RandU<std::uint8_t>(15)};
+
+    constexpr std::size_t kCalls = 20'000'000;
+    const struct { const char* name; float attack, defense, destroy; } cases[] = {
+        {"all off",      0.0f, 0.0f, 0.0f},
+        {"defense only", 0.0f, 1.0f, 0.0f},
+        {"all on",       1.0f, 1.0f, 0.5f},
+    };
+    std::printf("hit dispatch with stub stages, ns per hit:\n");
+    for (const auto& c : cases) {
+        Configure(c.attack, c.defense, c.destroy);
+        // the selected function pointer is only known at run time, as after
+        // the settings are loaded
+        ProcessFn process = Select();
+        ProcessFn runtimeProcess = &ProcessRuntime;
+        Test::Keep(process);
+        Test::Keep(runtimeProcess);
+        std::size_t i = 0;
+        const double runtime = Test::NsPerOp(kCalls, 1, [&]() { runtimeProcess(hits[i++ & 4095]); });
+        const float expected = sink;
+        sink = 0;
+        i = 0;
+        const double variant = Test::NsPerOp(kCalls, 1, [&]() {
+            const auto& hit = hits[i++ & 4095];
+            if (process) process(hit);
+        });
+        CHECK(sink == expected);
+        CHECK(!process == !(c.attack || c.defense || c.destroy));
+        sink = 0;
+        std::printf("  %-12s runtime checks %.2f, Variants table %.2f\n", c.name, runtime, variant);
+    }
+    return 0;
+}
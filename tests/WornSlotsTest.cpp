@@ -0,0 +1,89 @@
+#include "WornSlots.h"
+#include "Check.h"
+
+#include <array>
+#include <memory>
+#include <random>
+
+// stand-ins for the engine types WornSlots.h only declares
+namespace RE {
+    class ExtraHealth {
+        public:
+            float health = 1.0f;
+    };
+    class ExtraDataList {
+        public:
+            ExtraHealth health;
+    };
+    class InventoryEntryData {
+        public:
+            std::array<ExtraDataList*, 2> worn{}; // right, left
+    };
+}
+
+DurabilityNG::Stats* DurabilityNG::Stats::GetSingleton() {
+    static Stats singleton;
+    return std::addressof(singleton);
+}
+
+using namespace DurabilityNG;
+
+// One actor with a handful of entries. Equip toggles free the worn list and
+// allocate a new one, as the game does when an item is re-equipped, between
+// hits that go through the locator and write the health it returns. Built
+// with AddressSanitizer, so a stale pointer that is dereferenced aborts.
+// The test clears valid itself right where it frees a list, standing in for
+// the equip and container sinks. So it proves that the cache resets and never
+// serves a list freed before the reset. It does not prove that the sinks see
+// every free the engine makes; that needs the game.
+// Returns how many hits got a list other than the current one.
+std::size_t Run(bool invalidate, std::uint32_t seed) {
+    constexpr std::size_t kEntries = 6;
+    std::array<RE::InventoryEntryData, kEntries> entries;
+    std::mt19937 rng(seed);
+    WornSlots worn;
+    auto locate = [](RE::InventoryEntryData* entry, bool left) {
+        auto* list = entry->worn[left];
+        return std::pair(list, list ? &list->health : nullptr);
+    };
+
+    std::size_t stale = 0;
+    for (int step = 0; step < 200'000; step++) {
+        auto& entry = entries[rng() % kEntries];
+        const bool left = rng() & 1;
+        if (rng() % 32 == 0) {
+            // equip, unequip or re-equip
+            delete entry.worn[left];
+            entry.worn[left] = rng() % 3 ? new RE::ExtraDataList : nullptr;
+            if (invalidate) worn.valid = false;
+            continue;
+        }
+        auto* slot = worn.Find(&entry, left, locate);
+        if ((slot ? slot->list : nullptr) != entry.worn[left]) {
+            stale++;
+            continue;
+        }
+        if (slot) {
+            CHECK(slot->health == &entry.worn[left]->health);
+            slot->health->health -= 0.001f;
+        }
+    }
+    for (auto& entry : entries)
+        for (auto* list : entry.worn) delete list;
+    return stale;
+}
+
+int main() {
+    for (std::uint32_t seed = 1; seed <= 4; seed++)
+        CHECK(Run(true, seed) == 0);
+
+    // without the equip sinks the locator hands out freed lists
+    CHECK(Run(false, 1) > 0);
+
+    const auto* stats = Stats::GetSingleton();
+    CHECK(stats->wornHits.load() > stats->wornMisses.load());
+    std::printf("WornSlots: %llu hits, %llu misses\n",
+        static_cast<unsigned long long>(stats->wornHits.load()),
+        static_cast<unsigned long long>(stats->wornMisses.load()));
+    return 0;
+}